@@ -0,0 +1,295 @@
+// Content-addressed cache of compiled grammars: the transformed grammar, its
+// FIRST/FOLLOW bitsets and the dense parse table, keyed by a hash of the
+// normalized source grammar
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <chrono>
+#include <filesystem>
+#include "Grammar.cpp"
+#include "GrammarReader.cpp"
+#include "FirstFollow.cpp"
+#include "ParseTable.cpp"
+using namespace std;
+
+const char CACHE_MAGIC[4] = {'L', 'L', '1', 'C'};
+const uint32_t CACHE_FORMAT_VERSION = 3;  // 2: FOLLOW sees through nullable suffixes, 3: sync sets
+
+// Function to hash bytes with 64-bit FNV-1a
+uint64_t fnv1a(string_view data, uint64_t hash = 14695981039346656037ULL) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Function to hash the loaded productions; they are already split into
+// tokens, so formatting changes to cfg.txt do not invalidate the cache
+uint64_t grammarHash(const ProductionList& productions) {
+    uint64_t hash = fnv1a("v" + to_string(CACHE_FORMAT_VERSION) + "\n");
+    for (size_t p = 0; p < productions.size(); ++p) {
+        hash = fnv1a(productions.lhs[p], hash);
+        hash = fnv1a(" ->", hash);
+        for (const string_view* token = productions.rhsBegin(p); token != productions.rhsEnd(p); ++token) {
+            hash = fnv1a(" ", hash);
+            hash = fnv1a(*token, hash);
+        }
+        hash = fnv1a("\n", hash);
+    }
+    return hash;
+}
+
+// Function to get the cache file name for a grammar hash
+string cachePath(const string& directory, uint64_t hash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.ll1", (unsigned long long)hash);
+    return directory + "/" + name;
+}
+
+// Helper functions for the binary layout: plain values, then length-prefixed arrays and strings
+template <typename T>
+void writeValue(ostream& out, const T& value) {
+    out.write((const char*)&value, sizeof(T));
+}
+
+template <typename T>
+void writeArray(ostream& out, const vector<T>& values) {
+    writeValue<uint64_t>(out, values.size());
+    if (!values.empty()) out.write((const char*)values.data(), values.size() * sizeof(T));
+}
+
+void writeSpan(ostream& out, SymbolSpan span) {
+    writeValue<uint64_t>(out, span.size());
+    if (!span.empty()) out.write((const char*)span.begin(), span.size() * sizeof(int));
+}
+
+void writeText(ostream& out, const string& text) {
+    writeValue<uint64_t>(out, text.size());
+    out.write(text.data(), text.size());
+}
+
+template <typename T>
+bool readValue(istream& in, T& value) {
+    return (bool)in.read((char*)&value, sizeof(T));
+}
+
+// Arrays and strings grow as their data arrives, a block at a time, so a damaged
+// length fails at the end of the file instead of allocating what it claims
+const size_t READ_BLOCK = 1 << 16;
+
+template <typename T>
+bool readArray(istream& in, vector<T>& values) {
+    uint64_t size;
+    if (!readValue(in, size) || size > (1ULL << 32)) return false;
+    values.clear();
+    while (values.size() < size) {
+        size_t at = values.size();
+        values.resize(min<uint64_t>(size, at + READ_BLOCK));
+        if (!in.read((char*)(values.data() + at), (values.size() - at) * sizeof(T))) return false;
+    }
+    return true;
+}
+
+bool readText(istream& in, string& text) {
+    uint64_t size;
+    if (!readValue(in, size) || size > (1ULL << 32)) return false;
+    text.clear();
+    while (text.size() < size) {
+        size_t at = text.size();
+        text.resize(min<uint64_t>(size, at + READ_BLOCK));
+        if (!in.read(&text[at], text.size() - at)) return false;
+    }
+    return true;
+}
+
+// Function to store the compiled grammar artifacts under their hash
+bool saveArtifacts(const string& path, uint64_t hash, const Grammar& grammar, const FirstFollowSet& sets,
+                   const ParseTable& table, int factoredNonTerminals, int recursionNonTerminals) {
+    error_code ignored;
+    filesystem::create_directories(filesystem::path(path).parent_path(), ignored);
+
+    // Write to a temporary name and rename, so concurrent readers never see half a file
+    string temporary = path + ".tmp" + to_string(chrono::steady_clock::now().time_since_epoch().count());
+    ofstream out(temporary, ios::binary);
+    if (!out) return false;
+
+    out.write(CACHE_MAGIC, 4);
+    writeValue(out, CACHE_FORMAT_VERSION);
+    writeValue(out, hash);
+
+    // Grammar: symbol names in id order (the reserved ε and $ are implied), then rules
+    writeValue<int32_t>(out, grammar.symbols.size());
+    for (int id = END_MARKER_ID + 1; id < grammar.symbols.size(); ++id) writeText(out, grammar.symbols.name(id));
+    writeValue<int32_t>(out, grammar.startSymbol);
+    writeArray(out, grammar.nonTerminals);
+    for (int nonTerminal : grammar.nonTerminals) {
+        writeValue<uint64_t>(out, grammar.rule(nonTerminal).size());
+        for (SymbolSpan rule : grammar.rule(nonTerminal)) writeSpan(out, rule);
+    }
+    writeValue<int32_t>(out, factoredNonTerminals);
+    writeValue<int32_t>(out, recursionNonTerminals);
+
+    // FIRST / FOLLOW bitsets
+    writeValue<int32_t>(out, sets.terminalCount());
+    writeArray(out, sets.firstSets().raw());
+    writeArray(out, sets.followSets().raw());
+
+    // Dense parse table (stored uncompressed)
+    writeValue<int32_t>(out, table.rows);
+    writeValue<int32_t>(out, table.columns);
+    writeArray(out, table.nonTerminalRow);
+    writeArray(out, table.terminalColumn);
+    writeArray(out, table.rowSymbol);
+    writeArray(out, table.columnSymbol);
+    writeArray(out, table.productionLhs);
+    writeArray(out, table.rhsStart);
+    writeArray(out, table.rhsSymbols);
+    vector<uint16_t> cells((size_t)table.rows * table.columns);
+    for (int row = 0; row < table.rows; ++row) {
+        for (int column = 0; column < table.columns; ++column) {
+            cells[(size_t)row * table.columns + column] = table.lookup(row, column);
+        }
+    }
+    writeArray(out, cells);
+    writeArray(out, table.syncSets);
+    writeValue<uint64_t>(out, table.conflicts.size());
+    for (const string& conflict : table.conflicts) writeText(out, conflict);
+    out.close();
+    if (!out) return false;
+
+    filesystem::rename(temporary, path, ignored);
+    if (ignored) filesystem::remove(temporary, ignored);
+    return true;
+}
+
+// Helper function to range check the index arrays of a loaded table: every symbol id,
+// row and column must point where lookup and tokenizeLine will follow it
+bool validTableIndexes(const ParseTable& table, int symbolCount) {
+    if (table.nonTerminalRow.size() != (size_t)symbolCount || table.terminalColumn.size() != (size_t)symbolCount ||
+        table.rowSymbol.size() != (size_t)table.rows || table.columnSymbol.size() != (size_t)table.columns) {
+        return false;
+    }
+    for (int id = 0; id < symbolCount; ++id) {
+        int row = table.nonTerminalRow[id], column = table.terminalColumn[id];
+        if (row < -1 || row >= table.rows || column < -1 || column >= table.columns) return false;
+        if (row >= 0 && table.rowSymbol[row] != id) return false;
+        if (column >= 0 && table.columnSymbol[column] != id) return false;
+    }
+    for (int symbol : table.rowSymbol) {
+        if (symbol < 0 || symbol >= symbolCount || table.nonTerminalRow[symbol] < 0) return false;
+    }
+    for (int symbol : table.columnSymbol) {
+        if (symbol < 0 || symbol >= symbolCount || table.terminalColumn[symbol] < 0) return false;
+    }
+    for (int lhs : table.productionLhs) {
+        if (lhs < 0 || lhs >= symbolCount || table.nonTerminalRow[lhs] < 0) return false;
+    }
+    return table.startSymbol >= 0 && table.startSymbol < symbolCount && table.nonTerminalRow[table.startSymbol] >= 0;
+}
+
+// Function to load cached artifacts; returns false on a miss, a version mismatch or a damaged file.
+// A file damaged only in its FIRST/FOLLOW words can leave the grammar replaced, so on false the
+// caller rebuilds everything.
+bool loadArtifacts(const string& path, uint64_t hash, Grammar& grammar, unique_ptr<FirstFollowSet>& sets,
+                   ParseTable& table, int& factoredNonTerminals, int& recursionNonTerminals) {
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t version;
+    uint64_t storedHash;
+    if (!in.read(magic, 4) || string(magic, 4) != string(CACHE_MAGIC, 4)) return false;
+    if (!readValue(in, version) || version != CACHE_FORMAT_VERSION) return false;
+    if (!readValue(in, storedHash) || storedHash != hash) return false;
+
+    Grammar loaded;
+    int32_t symbolCount, startSymbol;
+    if (!readValue(in, symbolCount)) return false;
+    for (int id = END_MARKER_ID + 1; id < symbolCount; ++id) {
+        string name;
+        if (!readText(in, name) || loaded.symbols.intern(name) != id) return false;
+    }
+    vector<int> nonTerminals;
+    if (!readValue(in, startSymbol) || !readArray(in, nonTerminals)) return false;
+    if (startSymbol < 0 || startSymbol >= symbolCount) return false;
+    loaded.grow();
+    vector<int> rule;
+    vector<char> listed(symbolCount, 0);
+    for (int nonTerminal : nonTerminals) {
+        uint64_t count;
+        if (!readValue(in, count) || nonTerminal < 0 || nonTerminal >= symbolCount || listed[nonTerminal]) return false;
+        listed[nonTerminal] = 1;
+        for (uint64_t i = 0; i < count; ++i) {
+            if (!readArray(in, rule)) return false;
+            for (int symbol : rule) {
+                if (symbol < 0 || symbol >= symbolCount) return false;
+            }
+            loaded.addAlternative(nonTerminal, rule);
+        }
+    }
+    if (!listed[startSymbol]) return false;
+    loaded.nonTerminals = nonTerminals;  // also the rules left without alternatives
+    loaded.startSymbol = startSymbol;
+    int32_t factored, recursion, terminalCount;
+    if (!readValue(in, factored) || !readValue(in, recursion) || !readValue(in, terminalCount)) return false;
+
+    vector<uint64_t> firstWords, followWords;
+    if (terminalCount != symbolCount - (int)loaded.nonTerminals.size()) return false;
+    if (!readArray(in, firstWords) || !readArray(in, followWords)) return false;
+
+    ParseTable loadedTable;
+    loadedTable.symbols = loaded.symbols;
+    loadedTable.startSymbol = startSymbol;
+    uint64_t conflictCount;
+    if (!readValue(in, loadedTable.rows) || !readValue(in, loadedTable.columns) ||
+        !readArray(in, loadedTable.nonTerminalRow) || !readArray(in, loadedTable.terminalColumn) ||
+        !readArray(in, loadedTable.rowSymbol) || !readArray(in, loadedTable.columnSymbol) ||
+        !readArray(in, loadedTable.productionLhs) || !readArray(in, loadedTable.rhsStart) ||
+        !readArray(in, loadedTable.rhsSymbols) || !readArray(in, loadedTable.cells) ||
+        !readArray(in, loadedTable.syncSets) || !readValue(in, conflictCount)) {
+        return false;
+    }
+    // Reject damaged files before anything indexes through them
+    if (loadedTable.rows < 0 || loadedTable.columns < 0) return false;
+    size_t productionCount = loadedTable.productionLhs.size();
+    if (loadedTable.cells.size() != (size_t)loadedTable.rows * loadedTable.columns) return false;
+    loadedTable.syncWords = (loadedTable.columns + 63) / 64;
+    if (loadedTable.syncSets.size() != (size_t)loadedTable.rows * loadedTable.syncWords) return false;
+    if (loadedTable.rhsStart.size() != productionCount + 1 || loadedTable.rhsStart[0] != 0) return false;
+    for (size_t p = 0; p < productionCount; ++p) {
+        if (loadedTable.rhsStart[p] > loadedTable.rhsStart[p + 1]) return false;
+    }
+    if ((size_t)loadedTable.rhsStart[productionCount] != loadedTable.rhsSymbols.size()) return false;
+    for (int symbol : loadedTable.rhsSymbols) {
+        if (symbol < 0 || symbol >= symbolCount) return false;
+    }
+    for (uint16_t cell : loadedTable.cells) {
+        if (cell != NO_PRODUCTION && cell >= productionCount) return false;
+    }
+    if (!validTableIndexes(loadedTable, symbolCount)) return false;
+    for (uint64_t i = 0; i < conflictCount; ++i) {
+        string conflict;
+        if (!readText(in, conflict)) return false;
+        loadedTable.conflicts.push_back(conflict);
+    }
+
+    // The sets use the grammar in place, so they are built on the caller's copy
+    grammar = move(loaded);
+    sets.reset(new FirstFollowSet(grammar));
+    if (!sets->restoreSets(firstWords, followWords)) {
+        sets.reset();
+        return false;
+    }
+    table = loadedTable;
+    factoredNonTerminals = factored;
+    recursionNonTerminals = recursion;
+    return true;
+}
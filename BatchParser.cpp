@@ -0,0 +1,236 @@
+// Batch validation of many independent inputs against one grammar: inputs are
+// sharded across a work-stealing thread pool that shares one read-only table
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include "ParseEngine.cpp"
+using namespace std;
+
+// Inputs held as whole file contents; every non-empty line is one input
+struct BatchInputs {
+    struct Line {
+        int file;
+        int lineNumber;
+        size_t begin;
+        size_t length;
+    };
+    vector<string> files;      // file names
+    vector<string> contents;   // file contents, indexed like files
+    vector<Line> lines;
+
+    string_view text(size_t input) const {
+        const Line& line = lines[input];
+        return string_view(contents[line.file]).substr(line.begin, line.length);
+    }
+
+    // Function to describe an input as "file:line"
+    string location(size_t input) const {
+        return files[lines[input].file] + ":" + to_string(lines[input].lineNumber);
+    }
+};
+
+struct BatchResult {
+    vector<char> accepted;     // per input
+    size_t acceptedCount = 0;
+    size_t tokens = 0;
+    size_t steals = 0;         // chunks a worker took from another worker's queue
+    int threads = 0;
+    double seconds = 0;
+
+    double tokensPerSecond() const {
+        return seconds > 0 ? tokens / seconds : 0;
+    }
+
+    double inputsPerSecond() const {
+        return seconds > 0 ? accepted.size() / seconds : 0;
+    }
+};
+
+// Helper function to split one file's contents into input lines
+void addBatchFile(BatchInputs& inputs, const string& name, string contents) {
+    int file = inputs.files.size();
+    inputs.files.push_back(name);
+    inputs.contents.push_back(move(contents));
+    const string& text = inputs.contents.back();
+
+    size_t begin = 0;
+    int lineNumber = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == string::npos) end = text.size();
+        ++lineNumber;
+        string_view line = string_view(text).substr(begin, end - begin);
+        if (line.find_first_not_of(" \t\r") != string_view::npos) {
+            inputs.lines.push_back({file, lineNumber, begin, end - begin});
+        }
+        begin = end + 1;
+    }
+}
+
+// Function to read a file, or every regular file under a directory, as batch inputs
+bool loadBatchInputs(const string& path, BatchInputs& inputs) {
+    error_code error;
+    vector<string> paths;
+    if (filesystem::is_directory(path, error)) {
+        for (const auto& entry : filesystem::recursive_directory_iterator(path, error)) {
+            if (entry.is_regular_file()) paths.push_back(entry.path().string());
+        }
+        sort(paths.begin(), paths.end());
+    } else {
+        paths.push_back(path);
+    }
+
+    for (const string& name : paths) {
+        ifstream file(name, ios::binary);
+        if (!file) {
+            cerr << "Error: Unable to open file " << name << endl;
+            return false;
+        }
+        stringstream contents;
+        contents << file.rdbuf();
+        addBatchFile(inputs, name, contents.str());
+    }
+    return true;
+}
+
+// Work-stealing pool over chunks of input indices. Every worker owns a queue:
+// it takes chunks from the back of its own queue and, once that is empty,
+// steals from the front of the others. A queue's lock is only ever shared
+// with a thief, so workers do not contend while they have work of their own.
+class BatchParser {
+private:
+    struct Chunk {
+        size_t begin;
+        size_t end;
+    };
+
+    struct alignas(64) WorkQueue {
+        mutex lock;
+        deque<Chunk> chunks;
+    };
+
+    struct alignas(64) WorkerTotals {
+        size_t accepted = 0;
+        size_t tokens = 0;
+        size_t steals = 0;
+    };
+
+    ParseTableView table;
+    int threadCount;
+    size_t chunkSize;
+    const DfaLexer* lexer = nullptr;  // without one, tokens are split at whitespace
+
+    bool popOwn(WorkQueue& queue, Chunk& chunk) {
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.chunks.empty()) return false;
+        chunk = queue.chunks.back();
+        queue.chunks.pop_back();
+        return true;
+    }
+
+    bool steal(WorkQueue& queue, Chunk& chunk) {
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.chunks.empty()) return false;
+        chunk = queue.chunks.front();
+        queue.chunks.pop_front();
+        return true;
+    }
+
+    void work(int self, vector<WorkQueue>& queues, const BatchInputs& inputs, vector<char>& accepted,
+              WorkerTotals& totals) {
+        // Per-thread engine (and so parse stack) and token buffer
+        LL1ParseEngine engine(table);
+        vector<int> tokens;
+        Chunk chunk;
+        for (;;) {
+            bool found = popOwn(queues[self], chunk);
+            for (int k = 1; !found && k < threadCount; ++k) {
+                found = steal(queues[(self + k) % threadCount], chunk);
+                if (found) totals.steals++;
+            }
+            // Chunks are never added once work starts, so empty queues everywhere means done
+            if (!found) return;
+
+            for (size_t input = chunk.begin; input < chunk.end; ++input) {
+                if (lexer) lexer->tokenize(inputs.text(input), tokens);
+                else tokenizeText(table, inputs.text(input), tokens);
+                bool result = engine.parse(tokens);
+                accepted[input] = result;
+                totals.accepted += result;
+                totals.tokens += tokens.size();
+            }
+        }
+    }
+
+public:
+    // Constructor: threads <= 0 uses every hardware thread
+    BatchParser(const ParseTableView& parseTable, int threads = 0, size_t chunk = 256)
+        : table(parseTable), threadCount(threads), chunkSize(chunk < 1 ? 1 : chunk) {
+        if (threadCount <= 0) threadCount = max(1u, thread::hardware_concurrency());
+    }
+
+    // Function to tokenize inputs with a generated lexer, shared read-only by the workers
+    void setLexer(const DfaLexer* dfaLexer) { lexer = dfaLexer; }
+
+    // Function to parse every input and collect per-input results and throughput
+    BatchResult parse(const BatchInputs& inputs) {
+        BatchResult result;
+        size_t count = inputs.lines.size();
+        result.threads = threadCount;
+        result.accepted.assign(count, 0);
+
+        // Deal contiguous runs of chunks to each worker so neighbours stay on one thread
+        vector<WorkQueue> queues(threadCount);
+        size_t chunks = (count + chunkSize - 1) / chunkSize;
+        for (size_t c = 0; c < chunks; ++c) {
+            size_t owner = c * threadCount / chunks;
+            queues[owner].chunks.push_back({c * chunkSize, min(count, (c + 1) * chunkSize)});
+        }
+        // Owners pop from the back, so reverse each queue to work through it front to back
+        for (WorkQueue& queue : queues) reverse(queue.chunks.begin(), queue.chunks.end());
+
+        vector<WorkerTotals> totals(threadCount);
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (int t = 1; t < threadCount; ++t) {
+            workers.emplace_back([&, t] { work(t, queues, inputs, result.accepted, totals[t]); });
+        }
+        work(0, queues, inputs, result.accepted, totals[0]);
+        for (thread& worker : workers) worker.join();
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        for (const WorkerTotals& worker : totals) {
+            result.acceptedCount += worker.accepted;
+            result.tokens += worker.tokens;
+            result.steals += worker.steals;
+        }
+        return result;
+    }
+};
+
+// Function to print the rejected inputs and the aggregate throughput of a batch
+void printBatchResult(const BatchInputs& inputs, const BatchResult& result, bool listRejected) {
+    if (listRejected) {
+        for (size_t i = 0; i < result.accepted.size(); ++i) {
+            if (!result.accepted[i]) cout << "REJECT  " << inputs.location(i) << "  " << inputs.text(i) << "\n";
+        }
+    }
+    size_t count = result.accepted.size();
+    cout << "\nBatch: " << count << " inputs from " << inputs.files.size() << " file(s) ("
+         << result.acceptedCount << " accepted, " << count - result.acceptedCount << " rejected), "
+         << result.tokens << " tokens on " << result.threads << " thread(s) in " << result.seconds * 1000
+         << " ms = " << (size_t)result.inputsPerSecond() << " inputs/s, " << (size_t)result.tokensPerSecond()
+         << " tokens/s, " << result.steals << " steals" << endl;
+}
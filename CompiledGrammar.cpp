@@ -0,0 +1,272 @@
+// Compile-time grammar compilation: a grammar written as a string literal is
+// turned into FIRST/FOLLOW sets and an LL(1) table by constexpr code, so the
+// table lives in read-only data with no startup cost or allocation. A
+// malformed or non-LL(1) grammar stops the build at the line that rejected it.
+//
+//   constexpr auto table = compileGrammar("E -> T A\nA -> + T A | ε\n...");
+//   LL1ParseEngine engine(table.view());
+//
+// The grammar must already be LL(1): left factoring and left recursion removal
+// are run-time transformations. Symbol ids, terminal columns and production
+// order follow the run-time pipeline, and FOLLOW uses the full definition
+// (every nullable suffix), so conflicts hidden behind a nullable run are caught.
+
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include "ParseTable.cpp"
+#include "GrammarReader.cpp"
+using namespace std;
+
+template <int MaxSymbols = 64, int MaxProductions = 128, int MaxRhsSymbols = 512, int MaxNameBytes = 1024>
+struct StaticParseTable {
+    int symbolCount = 0;
+    int startSymbol = -1;
+    int rows = 0;
+    int columns = 0;
+    int productionCount = 0;
+    int nameBytes = 0;
+
+    uint32_t nameOffsets[MaxSymbols + 1] = {};
+    char names[MaxNameBytes] = {};
+    int nameOrder[MaxSymbols] = {};
+    bool nonTerminal[MaxSymbols] = {};
+    int nonTerminalRow[MaxSymbols] = {};
+    int terminalColumn[MaxSymbols] = {};
+    int rowSymbol[MaxSymbols] = {};
+    int columnSymbol[MaxSymbols] = {};
+    int productionLhs[MaxProductions] = {};
+    int rhsStart[MaxProductions + 1] = {};
+    int rhsSymbols[MaxRhsSymbols] = {};
+    uint64_t first[MaxSymbols] = {};     // bit per terminal column, bit 0 is ε
+    uint64_t follow[MaxSymbols] = {};
+    uint64_t sync[MaxSymbols] = {};      // per row: FOLLOW plus $, for error recovery
+    uint16_t cells[MaxSymbols * 64] = {};
+
+    constexpr string_view name(int id) const {
+        return string_view(names + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+    }
+
+    constexpr uint16_t lookup(int row, int column) const {
+        return cells[row * columns + column];
+    }
+
+    // Function to get a view the parse engine can run on directly
+    ParseTableView view() const {
+        ParseTableView v;
+        v.symbolCount = symbolCount;
+        v.startSymbol = startSymbol;
+        v.rows = rows;
+        v.columns = columns;
+        v.productionCount = productionCount;
+        v.nonTerminalRow = nonTerminalRow;
+        v.terminalColumn = terminalColumn;
+        v.rowSymbol = rowSymbol;
+        v.columnSymbol = columnSymbol;
+        v.productionLhs = productionLhs;
+        v.rhsStart = rhsStart;
+        v.rhsSymbols = rhsSymbols;
+        v.cells = cells;
+        v.syncWords = 1;
+        v.syncSets = sync;
+        v.nameOffsets = nameOffsets;
+        v.names = names;
+        v.nameOrder = nameOrder;
+        return v;
+    }
+};
+
+// Evaluating a throw during constant evaluation is what fails the build; the
+// reason string shows up in the compiler's diagnostic
+constexpr void grammarError(const char* reason) {
+    if (reason) throw reason;
+}
+
+// Helper function to get (or create) the id for a symbol name
+template <typename Table>
+constexpr int internStatic(Table& table, string_view text, int maxSymbols, int maxNameBytes) {
+    for (int id = 0; id < table.symbolCount; ++id) {
+        if (table.name(id) == text) return id;
+    }
+    if (table.symbolCount == maxSymbols) grammarError("grammar has more symbols than MaxSymbols");
+    if (table.nameBytes + (int)text.size() > maxNameBytes) grammarError("symbol names exceed MaxNameBytes");
+    for (char c : text) table.names[table.nameBytes++] = c;
+    table.nameOffsets[++table.symbolCount] = table.nameBytes;
+    return table.symbolCount - 1;
+}
+
+// Function to compile "A -> x y | z | ε" lines (one or more per non-terminal; → works
+// as well as ->) into an LL(1) table
+template <int MaxSymbols = 64, int MaxProductions = 128, int MaxRhsSymbols = 512, int MaxNameBytes = 1024>
+constexpr StaticParseTable<MaxSymbols, MaxProductions, MaxRhsSymbols, MaxNameBytes> compileGrammar(string_view text) {
+    StaticParseTable<MaxSymbols, MaxProductions, MaxRhsSymbols, MaxNameBytes> table;
+    internStatic(table, "ε", MaxSymbols, MaxNameBytes);
+    internStatic(table, "$", MaxSymbols, MaxNameBytes);
+
+    // Productions in source order; they are regrouped by non-terminal below. ε
+    // tokens are kept until then, so repeats are found token by token as the
+    // run-time reader finds them.
+    int sourceLhs[MaxProductions] = {};
+    int sourceStart[MaxProductions + 1] = {};
+    int sourceSymbols[MaxRhsSymbols] = {};
+    int sourceCount = 0, symbolTotal = 0;
+
+    // Ends the open alternative; empty and repeated alternatives are dropped
+    auto closeAlternative = [&](int lhs) {
+        int length = symbolTotal - sourceStart[sourceCount];
+        bool repeated = length == 0;
+        for (int p = 0; p < sourceCount && !repeated; ++p) {
+            if (sourceLhs[p] != lhs || sourceStart[p + 1] - sourceStart[p] != length) continue;
+            repeated = true;
+            for (int k = 0; k < length && repeated; ++k) {
+                repeated = sourceSymbols[sourceStart[p] + k] == sourceSymbols[sourceStart[sourceCount] + k];
+            }
+        }
+        if (repeated) {
+            symbolTotal = sourceStart[sourceCount];
+            return;
+        }
+        if (sourceCount == MaxProductions) grammarError("grammar has more productions than MaxProductions");
+        sourceLhs[sourceCount++] = lhs;
+        sourceStart[sourceCount] = symbolTotal;
+    };
+
+    // Lines are tokenized by the run-time grammar lexer; a line the reader would
+    // skip as malformed stops the build. "A ->" declares A without alternatives.
+    GrammarLexer lexer(text);
+    string_view token;
+    int lhs = -1;
+    bool arrowSeen = false;
+    for (GrammarTokenKind kind = lexer.next(token);; kind = lexer.next(token)) {
+        if (kind == GRAMMAR_NEWLINE || kind == GRAMMAR_END) {
+            if (arrowSeen) closeAlternative(lhs);
+            else if (lhs >= 0) grammarError("grammar line without \"->\"");
+            if (kind == GRAMMAR_END) break;
+            lhs = -1;
+            arrowSeen = false;
+        } else if (!arrowSeen) {
+            if (kind == GRAMMAR_NAME && lhs < 0) lhs = internStatic(table, token, MaxSymbols, MaxNameBytes);
+            else if (kind == GRAMMAR_ARROW && lhs >= 0) arrowSeen = true;
+            else grammarError("grammar line is not \"A -> α | β\"");
+            if (!arrowSeen) continue;
+            if (!table.nonTerminal[lhs]) {
+                table.nonTerminal[lhs] = true;
+                table.rowSymbol[table.rows++] = lhs;
+            }
+            if (table.startSymbol < 0) table.startSymbol = lhs;
+        } else if (kind == GRAMMAR_BAR) {
+            closeAlternative(lhs);
+        } else {
+            if (symbolTotal == MaxRhsSymbols) grammarError("grammar has more symbols than MaxRhsSymbols");
+            sourceSymbols[symbolTotal++] = internStatic(table, token, MaxSymbols, MaxNameBytes);
+        }
+    }
+    if (table.startSymbol < 0) grammarError("grammar has no productions");
+
+    // Rows in order of first definition, columns are every other symbol in id order
+    for (int id = 0; id < table.symbolCount; ++id) table.nonTerminalRow[id] = table.terminalColumn[id] = -1;
+    for (int row = 0; row < table.rows; ++row) table.nonTerminalRow[table.rowSymbol[row]] = row;
+    for (int id = 0; id < table.symbolCount; ++id) {
+        if (!table.nonTerminal[id]) {
+            if (table.columns == 64) grammarError("compile-time grammars support at most 63 terminals");
+            table.terminalColumn[id] = table.columns;
+            table.columnSymbol[table.columns++] = id;
+            table.first[id] = 1ULL << table.terminalColumn[id];
+        }
+    }
+
+    // Productions grouped by non-terminal in row order, alternatives in source order
+    for (int row = 0; row < table.rows; ++row) {
+        for (int p = 0; p < sourceCount; ++p) {
+            if (sourceLhs[p] != table.rowSymbol[row]) continue;
+            table.productionLhs[table.productionCount] = sourceLhs[p];
+            int length = table.rhsStart[table.productionCount];
+            for (int k = sourceStart[p]; k < sourceStart[p + 1]; ++k) {
+                if (sourceSymbols[k] != EPSILON_ID) table.rhsSymbols[length++] = sourceSymbols[k];
+            }
+            table.rhsStart[++table.productionCount] = length;
+        }
+    }
+
+    // Symbol ids sorted by name for ParseTableView::find
+    for (int id = 0; id < table.symbolCount; ++id) {
+        int k = id;
+        for (; k > 0 && table.name(id) < table.name(table.nameOrder[k - 1]); --k) {
+            table.nameOrder[k] = table.nameOrder[k - 1];
+        }
+        table.nameOrder[k] = id;
+    }
+
+    // FIRST by fixed-point iteration
+    const uint64_t epsilon = 1ULL << EPSILON_BIT;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int p = 0; p < table.productionCount; ++p) {
+            uint64_t bits = epsilon;
+            for (int k = table.rhsStart[p]; k < table.rhsStart[p + 1] && (bits & epsilon); ++k) {
+                bits = (bits & ~epsilon) | table.first[table.rhsSymbols[k]];
+            }
+            uint64_t& target = table.first[table.productionLhs[p]];
+            if ((target | bits) != target) {
+                target |= bits;
+                changed = true;
+            }
+        }
+    }
+
+    // FOLLOW by fixed-point iteration over every nullable suffix
+    table.follow[table.startSymbol] = 1ULL << table.terminalColumn[END_MARKER_ID];
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int p = 0; p < table.productionCount; ++p) {
+            uint64_t trailer = table.follow[table.productionLhs[p]];
+            for (int k = table.rhsStart[p + 1] - 1; k >= table.rhsStart[p]; --k) {
+                int symbol = table.rhsSymbols[k];
+                if (!table.nonTerminal[symbol]) {
+                    trailer = table.first[symbol];
+                    continue;
+                }
+                if ((table.follow[symbol] | trailer) != table.follow[symbol]) {
+                    table.follow[symbol] |= trailer;
+                    changed = true;
+                }
+                uint64_t symbolFirst = table.first[symbol] & ~epsilon;
+                trailer = (table.first[symbol] & epsilon) ? trailer | symbolFirst : symbolFirst;
+            }
+        }
+    }
+
+    // Synchronization sets for panic-mode recovery
+    for (int row = 0; row < table.rows; ++row) {
+        table.sync[row] = (table.follow[table.rowSymbol[row]] & ~epsilon) | 1ULL << table.terminalColumn[END_MARKER_ID];
+    }
+
+    // Table: predict set of every production; two productions on one cell is a conflict
+    for (int i = 0; i < table.rows * table.columns; ++i) table.cells[i] = NO_PRODUCTION;
+    for (int p = 0; p < table.productionCount; ++p) {
+        uint64_t predict = epsilon;
+        for (int k = table.rhsStart[p]; k < table.rhsStart[p + 1] && (predict & epsilon); ++k) {
+            predict = (predict & ~epsilon) | table.first[table.rhsSymbols[k]];
+        }
+        if (predict & epsilon) predict |= table.follow[table.productionLhs[p]];
+        predict &= ~epsilon;
+
+        int row = table.nonTerminalRow[table.productionLhs[p]];
+        for (int column = 1; column < table.columns; ++column) {
+            if (!(predict >> column & 1)) continue;
+            uint16_t& cell = table.cells[row * table.columns + column];
+            if (cell != NO_PRODUCTION) grammarError("grammar is not LL(1): two productions share a table cell");
+            cell = p;
+        }
+    }
+    return table;
+}
+
+// The expression grammar from cfg.txt after left recursion removal, compiled into the binary
+constexpr string_view EXPRESSION_GRAMMAR_TEXT =
+    "E -> T A\n"
+    "A -> + T A | ε\n"
+    "T -> F B\n"
+    "B -> * F B | ε\n"
+    "F -> id | ( E )\n";
+constexpr auto EXPRESSION_GRAMMAR = compileGrammar<16, 16, 32, 64>(EXPRESSION_GRAMMAR_TEXT);
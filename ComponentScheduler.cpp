@@ -0,0 +1,91 @@
+// Running one task per strongly connected component of a dependency graph on a
+// thread pool, starting each component only after everything it depends on
+
+#pragma once
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+using namespace std;
+
+// Function to pick a worker count: threads <= 0 uses every hardware thread
+int workerCount(int threads) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    return threads;
+}
+
+// Function to call task(c) once for every component c. dependents[c] lists the
+// components that may only start after c is done (an edge listed twice counts
+// twice). A worker that finishes a component keeps one newly ready dependent
+// for itself, so a long chain runs on one thread without touching the shared
+// queue. With one thread the components run in a fixed topological order.
+template <typename Task>
+void runComponents(const vector<vector<int>>& dependents, int threads, Task task) {
+    int count = dependents.size();
+    if (count == 0) return;
+    threads = min(workerCount(threads), count);
+
+    unique_ptr<atomic<int>[]> pending(new atomic<int>[count]);
+    for (int c = 0; c < count; ++c) pending[c].store(0, memory_order_relaxed);
+    for (const auto& list : dependents) {
+        for (int d : list) pending[d].fetch_add(1, memory_order_relaxed);
+    }
+
+    mutex lock;
+    condition_variable wake;
+    deque<int> ready;
+    atomic<int> remaining(count);
+    for (int c = 0; c < count; ++c) {
+        if (pending[c].load(memory_order_relaxed) == 0) ready.push_back(c);
+    }
+
+    auto work = [&] {
+        vector<int> unlocked;
+        int next = -1;
+        for (;;) {
+            if (next < 0) {
+                unique_lock<mutex> guard(lock);
+                wake.wait(guard, [&] { return !ready.empty() || remaining == 0; });
+                if (ready.empty()) return;
+                next = ready.front();
+                ready.pop_front();
+            }
+
+            int c = next;
+            task(c);
+            next = -1;
+            unlocked.clear();
+            for (int d : dependents[c]) {
+                if (pending[d].fetch_sub(1, memory_order_acq_rel) == 1) unlocked.push_back(d);
+            }
+            if (!unlocked.empty()) next = unlocked.back();
+
+            // The shared queue is only touched to hand work to others or to finish
+            bool finished = remaining.fetch_sub(1, memory_order_acq_rel) == 1;
+            if (unlocked.size() > 1 || finished) {
+                lock_guard<mutex> guard(lock);
+                if (unlocked.size() > 1) ready.insert(ready.end(), unlocked.begin(), unlocked.end() - 1);
+                wake.notify_all();
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < threads; ++t) workers.emplace_back(work);
+    work();
+    for (thread& worker : workers) worker.join();
+}
+
+// Function to call task(begin, end) for consecutive ranges of [0, count) with at
+// most chunk items each, the ranges spread over the workers
+template <typename Task>
+void parallelChunks(size_t count, size_t chunk, int threads, Task task) {
+    size_t chunks = (count + chunk - 1) / chunk;
+    runComponents(vector<vector<int>>(chunks), threads, [&](int c) {
+        task((size_t)c * chunk, min(count, ((size_t)c + 1) * chunk));
+    });
+}
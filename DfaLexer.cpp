@@ -0,0 +1,513 @@
+// Lexer generated from a parse table's terminals: every terminal matches its own
+// name unless a spec line gives it a regular expression ("id = [A-Za-z_]\w*").
+// The patterns are compiled to one minimized DFA over byte classes, and text is
+// scanned by longest match, ties going to literal terminals first and then to
+// spec lines in order.
+//
+// Spec syntax: "name = regex" per line, '#' starts a comment line. Regexes take
+// literals, '.', [a-z] and [^...] classes, \d \w \s, escapes, ( ), |, *, + and ?.
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <bitset>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <cstdint>
+#include <iostream>
+#include "ParseTable.cpp"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+struct LexRule {
+    string terminal;
+    string pattern;
+};
+
+// Function to read "name = regex" lines; returns false if the file cannot be read
+bool loadLexerSpec(const string& filename, vector<LexRule>& rules) {
+    ifstream file(filename);
+    if (!file) {
+        cerr << "Error: Unable to open file " << filename << endl;
+        return false;
+    }
+    string line;
+    while (getline(file, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == string::npos || line[start] == '#') continue;
+        size_t equals = line.find('=', start);
+        if (equals == string::npos) {
+            cerr << "Error: lexer spec line must look like \"name = regex\": " << line << endl;
+            return false;
+        }
+        size_t nameEnd = line.find_last_not_of(" \t", equals - 1);
+        size_t patternStart = line.find_first_not_of(" \t", equals + 1);
+        size_t patternEnd = line.find_last_not_of(" \t\r");
+        if (nameEnd == string::npos || nameEnd < start || patternStart == string::npos || patternStart > patternEnd) {
+            cerr << "Error: lexer spec line must look like \"name = regex\": " << line << endl;
+            return false;
+        }
+        rules.push_back({line.substr(start, nameEnd + 1 - start), line.substr(patternStart, patternEnd + 1 - patternStart)});
+    }
+    return true;
+}
+
+// Helper functions for the byte sets the scanner skips in bulk
+inline bool isLexSpace(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool isIdentifierByte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Thompson NFA over bytes, built one pattern at a time
+class LexNfa {
+public:
+    struct State {
+        vector<int> epsilon;
+        bitset<256> bytes;      // bytes leading to next
+        int next = -1;
+        int accept = -1;        // priority of the pattern this state accepts (lower wins)
+    };
+    vector<State> states;
+
+private:
+    struct Fragment {
+        int start, end;
+    };
+
+    string_view pattern;
+    size_t at = 0;
+    string errorText;
+
+    int addState() {
+        states.emplace_back();
+        return states.size() - 1;
+    }
+
+    Fragment byteSet(const bitset<256>& bytes) {
+        Fragment f = {addState(), addState()};
+        states[f.start].bytes = bytes;
+        states[f.start].next = f.end;
+        return f;
+    }
+
+    bool fail(const string& text) {
+        if (errorText.empty()) errorText = text + " at offset " + to_string(at) + " of \"" + string(pattern) + "\"";
+        return false;
+    }
+
+    // Helper function for escapes: \d \w \s classes, \n \t \r, anything else literally
+    bitset<256> escaped(char c) {
+        bitset<256> bytes;
+        for (int b = 0; b < 256; ++b) {
+            if ((c == 'd' && b >= '0' && b <= '9') || (c == 'w' && isIdentifierByte(b)) || (c == 's' && isLexSpace(b))) {
+                bytes.set(b);
+            }
+        }
+        if (c == 'd' || c == 'w' || c == 's') return bytes;
+        bytes.set((unsigned char)(c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c));
+        return bytes;
+    }
+
+    bool parseClass(bitset<256>& bytes) {
+        bool negate = at < pattern.size() && pattern[at] == '^';
+        if (negate) ++at;
+        bool first = true;
+        while (at < pattern.size() && (pattern[at] != ']' || first)) {
+            first = false;
+            unsigned char low = pattern[at++];
+            if (low == '\\' && at < pattern.size()) {
+                bitset<256> single = escaped(pattern[at++]);
+                if (single.count() != 1) {
+                    bytes |= single;
+                    continue;
+                }
+                for (int b = 0; b < 256; ++b) {
+                    if (single[b]) low = b;
+                }
+            }
+            unsigned char high = low;
+            if (at + 1 < pattern.size() && pattern[at] == '-' && pattern[at + 1] != ']') {
+                high = pattern[at + 1];
+                at += 2;
+                if (high < low) return fail("reversed range in character class");
+            }
+            for (int b = low; b <= high; ++b) bytes.set(b);
+        }
+        if (at == pattern.size()) return fail("unterminated character class");
+        ++at;
+        if (negate) bytes.flip();
+        return true;
+    }
+
+    bool parseAtom(Fragment& f) {
+        char c = pattern[at++];
+        bitset<256> bytes;
+        if (c == '(') {
+            if (!parseAlternation(f)) return false;
+            if (at == pattern.size() || pattern[at] != ')') return fail("missing ')'");
+            ++at;
+            return true;
+        }
+        if (c == '[') {
+            if (!parseClass(bytes)) return false;
+        } else if (c == '.') {
+            bytes.set();
+            bytes.reset('\n');
+        } else if (c == '\\') {
+            if (at == pattern.size()) return fail("dangling '\\'");
+            bytes = escaped(pattern[at++]);
+        } else if (c == '*' || c == '+' || c == '?' || c == ')') {
+            --at;
+            return fail(string("unexpected '") + c + "'");
+        } else {
+            bytes.set((unsigned char)c);
+        }
+        f = byteSet(bytes);
+        return true;
+    }
+
+    bool parseRepeat(Fragment& f) {
+        if (!parseAtom(f)) return false;
+        while (at < pattern.size() && (pattern[at] == '*' || pattern[at] == '+' || pattern[at] == '?')) {
+            char op = pattern[at++];
+            Fragment r = {addState(), addState()};
+            states[r.start].epsilon.push_back(f.start);
+            states[f.end].epsilon.push_back(r.end);
+            if (op != '+') states[r.start].epsilon.push_back(r.end);
+            if (op != '?') states[f.end].epsilon.push_back(f.start);
+            f = r;
+        }
+        return true;
+    }
+
+    bool parseSequence(Fragment& f) {
+        f.start = f.end = addState();
+        while (at < pattern.size() && pattern[at] != '|' && pattern[at] != ')') {
+            Fragment next;
+            if (!parseRepeat(next)) return false;
+            states[f.end].epsilon.push_back(next.start);
+            f.end = next.end;
+        }
+        return true;
+    }
+
+    bool parseAlternation(Fragment& f) {
+        if (!parseSequence(f)) return false;
+        while (at < pattern.size() && pattern[at] == '|') {
+            ++at;
+            Fragment next;
+            if (!parseSequence(next)) return false;
+            Fragment both = {addState(), addState()};
+            states[both.start].epsilon = {f.start, next.start};
+            states[f.end].epsilon.push_back(both.end);
+            states[next.end].epsilon.push_back(both.end);
+            f = both;
+        }
+        return true;
+    }
+
+public:
+    // Constructor: state 0 is the start state every pattern hangs off
+    LexNfa() { addState(); }
+
+    // Function to add a regular expression accepting with the given priority
+    bool addPattern(string_view regex, int priority) {
+        pattern = regex;
+        at = 0;
+        Fragment f;
+        if (!parseAlternation(f)) return false;
+        if (at != pattern.size()) return fail("unexpected ')'");
+        states[0].epsilon.push_back(f.start);
+        states[f.end].accept = priority;
+        return true;
+    }
+
+    // Function to add a string matched byte for byte
+    void addLiteral(string_view text, int priority) {
+        int current = addState();
+        states[0].epsilon.push_back(current);
+        for (unsigned char c : text) {
+            int next = addState();
+            states[current].bytes.set(c);
+            states[current].next = next;
+            current = next;
+        }
+        states[current].accept = priority;
+    }
+
+    const string& error() const {
+        return errorText;
+    }
+};
+
+// Minimized DFA lexer. Bytes are first mapped to equivalence classes, so the
+// transition table is states × classes 16-bit entries. State 0 is the dead state.
+class DfaLexer {
+private:
+    static const int DEAD = 0;
+
+    int startState = 1;
+    int classCount = 0;
+    uint8_t byteClass[256] = {};
+    vector<uint16_t> transitions;   // state * classCount + class -> state
+    vector<int> acceptTerminal;     // state -> terminal symbol id, or -1
+    vector<char> identifierLoop;    // state loops on exactly the identifier bytes
+    string errorText;
+
+    bool fail(const string& text) {
+        errorText = text;
+        return false;
+    }
+
+    int next(int state, unsigned char c) const {
+        return transitions[(size_t)state * classCount + byteClass[c]];
+    }
+
+    // Helper function to follow ε edges; sets stay sorted so they can be map keys.
+    // seen is stamped instead of cleared, so a closure costs only its own size.
+    static void closure(const LexNfa& nfa, vector<int>& set, vector<int>& seen, int stamp) {
+        for (size_t i = 0; i < set.size(); ++i) {
+            if (seen[set[i]] == stamp) {
+                set.erase(set.begin() + i--);
+                continue;
+            }
+            seen[set[i]] = stamp;
+        }
+        for (size_t i = 0; i < set.size(); ++i) {
+            for (int t : nfa.states[set[i]].epsilon) {
+                if (seen[t] != stamp) seen[t] = stamp, set.push_back(t);
+            }
+        }
+        sort(set.begin(), set.end());
+    }
+
+    // Helper function to merge equivalent states (Moore partition refinement), keeping
+    // the dead state at 0 and the start state at 1
+    void minimize() {
+        int count = acceptTerminal.size();
+        vector<int> block(count);
+        map<int, int> byAccept;
+        for (int s = 0; s < count; ++s) block[s] = byAccept.emplace(acceptTerminal[s], byAccept.size()).first->second;
+        int blocks = byAccept.size();
+        for (;;) {
+            map<vector<int>, int> bySignature;
+            vector<int> refined(count);
+            vector<int> signature(classCount + 1);
+            for (int s = 0; s < count; ++s) {
+                signature[0] = block[s];
+                for (int c = 0; c < classCount; ++c) signature[c + 1] = block[transitions[(size_t)s * classCount + c]];
+                refined[s] = bySignature.emplace(signature, bySignature.size()).first->second;
+            }
+            block.swap(refined);
+            if ((int)bySignature.size() == blocks) break;
+            blocks = bySignature.size();
+        }
+
+        // Renumber blocks: dead first, then start, then in order of first state
+        vector<int> number(blocks, -1);
+        int assigned = 0;
+        number[block[DEAD]] = assigned++;
+        if (number[block[startState]] < 0) number[block[startState]] = assigned++;
+        for (int s = 0; s < count; ++s) {
+            if (number[block[s]] < 0) number[block[s]] = assigned++;
+        }
+        vector<uint16_t> merged((size_t)blocks * classCount);
+        vector<int> accepts(blocks);
+        for (int s = 0; s < count; ++s) {
+            int b = number[block[s]];
+            accepts[b] = acceptTerminal[s];
+            for (int c = 0; c < classCount; ++c) {
+                merged[(size_t)b * classCount + c] = number[block[transitions[(size_t)s * classCount + c]]];
+            }
+        }
+        transitions.swap(merged);
+        acceptTerminal.swap(accepts);
+        startState = number[block[startState]];
+    }
+
+public:
+    // Function to generate the lexer for a table's terminals (ε and $ excluded)
+    bool build(const ParseTableView& table, const vector<LexRule>& rules) {
+        // Literal terminals outrank spec patterns, which rank in spec order
+        vector<int> terminalOf;
+        vector<char> hasRule(table.symbolCount, 0);
+        for (const LexRule& rule : rules) {
+            int id = table.terminalId(rule.terminal);
+            if (id < 0 || id == END_MARKER_ID) return fail("lexer rule for unknown terminal " + rule.terminal);
+            hasRule[id] = 1;
+        }
+        LexNfa nfa;
+        for (int column = 0; column < table.columns; ++column) {
+            int id = table.columnSymbol[column];
+            if (id == EPSILON_ID || id == END_MARKER_ID || hasRule[id]) continue;
+            nfa.addLiteral(table.name(id), terminalOf.size());
+            terminalOf.push_back(id);
+        }
+        for (const LexRule& rule : rules) {
+            if (!nfa.addPattern(rule.pattern, terminalOf.size())) return fail("lexer rule " + rule.terminal + ": " + nfa.error());
+            terminalOf.push_back(table.terminalId(rule.terminal));
+        }
+
+        // Byte classes: bytes no transition tells apart share a class
+        for (int b = 0; b < 256; ++b) byteClass[b] = 0;
+        classCount = 1;
+        for (const LexNfa::State& state : nfa.states) {
+            if (state.bytes.none()) continue;
+            int split[512];  // (class, in set) -> refined class
+            for (int k = 0; k < 2 * classCount; ++k) split[k] = -1;
+            int refined = 0;
+            for (int b = 0; b < 256; ++b) {
+                int& target = split[byteClass[b] * 2 + state.bytes[b]];
+                if (target < 0) target = refined++;
+                byteClass[b] = target;
+            }
+            classCount = refined;
+        }
+        vector<int> representative(classCount);
+        for (int b = 255; b >= 0; --b) representative[byteClass[b]] = b;
+
+        // Subset construction; DFA state 0 is the empty (dead) set
+        map<vector<int>, int> known;
+        vector<vector<int>> sets(1);
+        vector<int> seen(nfa.states.size(), 0);
+        int stamp = 0;
+        vector<int> start = {0};
+        closure(nfa, start, seen, ++stamp);
+        known[start] = 1;
+        sets.push_back(start);
+        transitions.assign((size_t)2 * classCount, DEAD);
+        acceptTerminal.assign(2, -1);
+        for (size_t d = 1; d < sets.size(); ++d) {
+            int best = -1;
+            for (int s : sets[d]) {
+                int priority = nfa.states[s].accept;
+                if (priority >= 0 && (best < 0 || priority < best)) best = priority;
+            }
+            acceptTerminal[d] = best < 0 ? -1 : terminalOf[best];
+
+            vector<vector<int>> targets(classCount);
+            for (int s : sets[d]) {
+                const LexNfa::State& state = nfa.states[s];
+                if (state.next < 0) continue;
+                for (int c = 0; c < classCount; ++c) {
+                    if (state.bytes[representative[c]]) targets[c].push_back(state.next);
+                }
+            }
+            for (int c = 0; c < classCount; ++c) {
+                vector<int>& target = targets[c];
+                if (target.empty()) continue;
+                closure(nfa, target, seen, ++stamp);
+                auto found = known.find(target);
+                int id;
+                if (found != known.end()) {
+                    id = found->second;
+                } else {
+                    if (sets.size() > 0xFFFF) return fail("lexer DFA has more states than a 16-bit table entry can hold");
+                    id = sets.size();
+                    known.emplace(target, id);
+                    sets.push_back(target);
+                    transitions.resize(sets.size() * classCount, DEAD);
+                    acceptTerminal.push_back(-1);
+                }
+                transitions[d * classCount + c] = id;
+            }
+        }
+        minimize();
+
+        // States whose self loops are exactly the identifier bytes can skip runs in bulk
+        identifierLoop.assign(acceptTerminal.size(), 0);
+        for (int s = 1; s < (int)acceptTerminal.size(); ++s) {
+            bool loops = true;
+            for (int b = 0; b < 256 && loops; ++b) loops = (next(s, b) == s) == isIdentifierByte(b);
+            identifierLoop[s] = loops;
+        }
+        return true;
+    }
+
+    // Function to skip whitespace from position i; returns the first other position.
+    // Most gaps are a single blank, so two bytes are checked before going wide.
+    static size_t skipSpace(string_view text, size_t i) {
+        for (size_t stop = min(text.size(), i + 2); i < stop; ++i) {
+            if (!isLexSpace(text[i])) return i;
+        }
+#ifdef __SSE2__
+        const __m128i tab = _mm_set1_epi8('\t' - 1), carriage = _mm_set1_epi8('\r' + 1), space = _mm_set1_epi8(' ');
+        for (; i + 16 <= text.size(); i += 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(text.data() + i));
+            __m128i control = _mm_and_si128(_mm_cmpgt_epi8(bytes, tab), _mm_cmplt_epi8(bytes, carriage));
+            int blank = _mm_movemask_epi8(_mm_or_si128(control, _mm_cmpeq_epi8(bytes, space)));
+            if (blank != 0xFFFF) return i + lowestBit(~(uint64_t)blank);
+        }
+#endif
+        while (i < text.size() && isLexSpace(text[i])) ++i;
+        return i;
+    }
+
+    // Function to skip identifier bytes from position i; returns the first other position.
+    // Short names end within a few bytes, so those are checked before going wide.
+    static size_t skipIdentifier(string_view text, size_t i) {
+        for (size_t stop = min(text.size(), i + 4); i < stop; ++i) {
+            if (!isIdentifierByte(text[i])) return i;
+        }
+#ifdef __SSE2__
+        const __m128i lowerA = _mm_set1_epi8('a' - 1), lowerZ = _mm_set1_epi8('z' + 1);
+        const __m128i digit0 = _mm_set1_epi8('0' - 1), digit9 = _mm_set1_epi8('9' + 1);
+        const __m128i caseBit = _mm_set1_epi8(0x20), underscore = _mm_set1_epi8('_');
+        for (; i + 16 <= text.size(); i += 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(text.data() + i));
+            __m128i lower = _mm_or_si128(bytes, caseBit);  // bytes >= 0x80 stay negative and match nothing
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, lowerA), _mm_cmplt_epi8(lower, lowerZ));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(bytes, digit0), _mm_cmplt_epi8(bytes, digit9));
+            __m128i word = _mm_or_si128(_mm_or_si128(letter, digit), _mm_cmpeq_epi8(bytes, underscore));
+            int run = _mm_movemask_epi8(word);
+            if (run != 0xFFFF) return i + lowestBit(~(uint64_t)run);
+        }
+#endif
+        while (i < text.size() && isIdentifierByte(text[i])) ++i;
+        return i;
+    }
+
+    // Function to append terminal ids from position i by longest match until the text
+    // ends or tokens holds limit entries; returns the position to resume from. Text
+    // no terminal matches becomes one -1 token, up to the next whitespace.
+    size_t tokenize(string_view text, size_t i, vector<int>& tokens, size_t limit) const {
+        i = skipSpace(text, i);
+        while (i < text.size() && tokens.size() < limit) {
+            int state = startState, terminal = -1;
+            size_t end = i;
+            for (size_t j = i; j < text.size();) {
+                state = next(state, text[j++]);
+                if (state == DEAD) break;
+                if (identifierLoop[state]) j = skipIdentifier(text, j);
+                if (acceptTerminal[state] >= 0) terminal = acceptTerminal[state], end = j;
+            }
+            if (terminal < 0) {
+                end = i + 1;
+                while (end < text.size() && !isLexSpace(text[end])) ++end;
+            }
+            tokens.push_back(terminal);
+            i = skipSpace(text, end);
+        }
+        return i;
+    }
+
+    // Function to split text into terminal ids
+    void tokenize(string_view text, vector<int>& tokens) const {
+        tokens.clear();
+        tokenize(text, 0, tokens, SIZE_MAX);
+    }
+
+    int stateCount() const { return acceptTerminal.size(); }
+    int byteClasses() const { return classCount; }
+
+    const string& error() const {
+        return errorText;
+    }
+};
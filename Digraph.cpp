@@ -0,0 +1,61 @@
+// Strongly connected components of a directed graph given as adjacency lists
+
+#pragma once
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+// Function to find strongly connected components with an iterative Tarjan
+// traversal (no recursion, so long dependency chains cannot overflow the stack).
+// component[v] receives the component number of v. Components are numbered in
+// reverse topological order: every edge u -> v has component[u] >= component[v].
+int stronglyConnectedComponents(const vector<vector<int>>& adjacency, vector<int>& component) {
+    int n = adjacency.size();
+    vector<int> index(n, -1), low(n, 0), stack, edgePos(n, 0);
+    vector<bool> onStack(n, false);
+    vector<int> callStack;
+    component.assign(n, -1);
+    int nextIndex = 0, componentCount = 0;
+
+    for (int root = 0; root < n; ++root) {
+        if (index[root] != -1) continue;
+        callStack.push_back(root);
+        index[root] = low[root] = nextIndex++;
+        stack.push_back(root);
+        onStack[root] = true;
+
+        while (!callStack.empty()) {
+            int v = callStack.back();
+            if (edgePos[v] < (int)adjacency[v].size()) {
+                int w = adjacency[v][edgePos[v]++];
+                if (index[w] == -1) {
+                    index[w] = low[w] = nextIndex++;
+                    stack.push_back(w);
+                    onStack[w] = true;
+                    callStack.push_back(w);
+                } else if (onStack[w]) {
+                    low[v] = min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            // All successors of v are done
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                int parent = callStack.back();
+                low[parent] = min(low[parent], low[v]);
+            }
+            if (low[v] == index[v]) {
+                int w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = false;
+                    component[w] = componentCount;
+                } while (w != v);
+                componentCount++;
+            }
+        }
+    }
+    return componentCount;
+}
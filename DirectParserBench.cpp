@@ -0,0 +1,101 @@
+// Benchmark of the direct-coded parser against the table-driven engine on the same inputs.
+//
+// GeneratedParser.cpp is the checked-in parser for cfg.txt (selfcheck fails if it
+// is stale). For another grammar, generate it again before building:
+//   temp --grammar grammar.txt --emit-parser GeneratedParser.cpp
+//   g++ -std=c++17 -O2 DirectParserBench.cpp -o bench
+//   bench [--grammar cfg.txt] [--repeat N] inputs.txt
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include "Pipeline.cpp"
+#include "ParseEngine.cpp"
+#include "GeneratedParser.cpp"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string filename = "cfg.txt";
+    string inputFile;
+    int repeat = 20;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--grammar" && i + 1 < argc) filename = argv[++i];
+        else if (arg == "--repeat" && i + 1 < argc) repeat = stoi(argv[++i]);
+        else inputFile = arg;
+    }
+
+    GrammarPipeline pipeline;
+    if (!pipeline.run(filename)) return 1;
+    const ParseTable& table = pipeline.table;
+
+    // The generated parser hard-codes symbol ids; make sure they are this grammar's
+    bool sameSymbols = DirectParser::symbolCount == table.symbols.size();
+    for (int id = 0; sameSymbols && id < table.symbols.size(); ++id) {
+        sameSymbols = table.symbols.name(id) == DirectParser::symbolName(id);
+    }
+    if (!sameSymbols) {
+        cerr << "Error: GeneratedParser.cpp was generated from a different grammar than " << filename << endl;
+        return 1;
+    }
+
+    ifstream file(inputFile);
+    if (!file) {
+        cerr << "Error: Unable to open file " << inputFile << endl;
+        return 1;
+    }
+    vector<vector<int>> inputs;
+    size_t tokens = 0;
+    string line;
+    while (getline(file, line)) {
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+        inputs.emplace_back();
+        tokenizeLine(table.view(), line, inputs.back());
+        tokens += inputs.back().size();
+    }
+
+    LL1ParseEngine engine(table);
+    DirectParser direct;
+    size_t engineAccepted = 0, directAccepted = 0, disagreements = 0, tooDeep = 0;
+    for (const auto& input : inputs) {
+        bool a = engine.parse(input), b = direct.parse(input.data(), input.size());
+        engineAccepted += a;
+        directAccepted += b;
+        disagreements += a != b;
+        tooDeep += direct.exceededDepth();
+    }
+
+    // Best of three timed rounds for each parser; the accept count is checked so the work is not optimized away
+    bool countsMatch = true;
+    auto timeRounds = [&](auto parseOne) {
+        double best = 1e300;
+        for (int round = 0; round < 3; ++round) {
+            size_t sink = 0;
+            auto start = chrono::steady_clock::now();
+            for (int r = 0; r < repeat; ++r) {
+                for (const auto& input : inputs) sink += parseOne(input);
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            countsMatch = countsMatch && sink == engineAccepted * repeat;
+            best = min(best, seconds);
+        }
+        return best;
+    };
+    double engineSeconds = timeRounds([&](const vector<int>& input) { return engine.parse(input); });
+    double directSeconds = timeRounds([&](const vector<int>& input) { return direct.parse(input.data(), input.size()); });
+
+    double total = (double)tokens * repeat;
+    cout << inputs.size() << " inputs, " << tokens << " tokens, " << repeat << " repeats\n"
+         << "table engine:  " << engineAccepted << " accepted, " << (size_t)(total / engineSeconds) << " tokens/s\n"
+         << "direct-coded:  " << directAccepted << " accepted, " << (size_t)(total / directSeconds) << " tokens/s\n"
+         << "speedup:       " << engineSeconds / directSeconds << "x\n";
+    if (disagreements || !countsMatch) {
+        cerr << "Error: the parsers disagree on " << disagreements << " inputs (" << tooDeep
+             << " nested deeper than the direct-coded parser's depth limit)" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,143 +1,553 @@
 // Class to compute FIRST and FOLLOW sets
 
+#pragma once
 #include <string>
 #include <vector>
 #include <set>
 #include <sstream>
-#define EPSILON "Îµ"
+#include <fstream>
+#define EPSILON "ε"
 #include <iostream>
 #include <map>
+#include <memory>
+#include "SymbolTable.cpp"
+#include "TerminalSet.cpp"
+#include "Digraph.cpp"
+#include "Grammar.cpp"
+#include "ComponentScheduler.cpp"
 using namespace std;
 
+// Work done by the last FIRST and FOLLOW computations
+struct SetSolverStats {
+    int firstComponents = 0;   // strongly connected components of the FIRST dependency graph
+    int firstPasses = 0;       // passes over component rules until they settled, summed
+    int followComponents = 0;  // strongly connected components of the FOLLOW inclusion graph
+    int followSweeps = 0;      // passes over the whole grammar (1 for the component solver)
+};
+
+// One place a symbol appears: position within alternative of lhs's rule
+struct SymbolOccurrence {
+    int lhs;
+    int alternative;
+    int position;
+};
+
 class FirstFollowSet {
 private:
-    map<string, vector<vector<string>>> productions;
-    string startSymbol;
+    unique_ptr<Grammar> ownGrammar;          // only for sets built from named productions
+    Grammar& productions;                    // alternatives by symbol id (ε stripped), shared with the caller
+    SymbolTable& symbols = productions.symbols;
+    vector<bool> nonTerminal;                // symbol id -> has productions (ids interned later are left out)
+    vector<int> nonTerminals;                // non-terminal ids in name order
+    vector<int> terminalIndex;               // symbol id -> bit index (ε is bit 0, -1 for non-terminals)
+    vector<int> terminalSymbols;             // bit index -> symbol id
+    int startSymbol;
+    int threads = 1;                         // workers for FIRST/FOLLOW (<= 0: every hardware thread)
+    bool namedSets = true;                   // fill first/follow after each full computation
+    TerminalSets firstBits;                  // symbol id -> FIRST set
+    TerminalSets followBits;                 // symbol id -> FOLLOW set
+    TerminalSets suffixBits;                 // suffix row -> FIRST of an alternative from one position on
+    vector<uint32_t> suffixRow;              // alternative index -> suffix row of its first position
+    SetSolverStats solverStats;
     
-    // Helper function to compute FIRST set for a symbol
-    void computeFirstHelper(const string& symbol) {
-        if (!first[symbol].empty()) return;
-    
-        for (const auto& production : productions[symbol]) {
-            bool epsilonInAll = true;
-            for (const auto& sym : production) {
-                if (productions.find(sym) == productions.end()) {
-                    first[symbol].insert(sym);
-                    epsilonInAll = false;
-                    break;
-                } else {
-                    computeFirstHelper(sym);
-                    first[symbol].insert(first[sym].begin(), first[sym].end());
-                    if (first[sym].find("ε") == first[sym].end()) {
-                        epsilonInAll = false;
-                        break;
-                    }
+    // Helper function to find the nullable non-terminals. Every alternative without
+    // a terminal counts down its non-nullable symbols; at zero its left side is nullable.
+    vector<char> findNullable() const {
+        int symbolCount = nonTerminal.size();
+        vector<char> nullable(symbolCount, 0);
+        vector<int> alternativeLhs, missing, worklist;
+        vector<uint32_t> start(symbolCount + 1, 0);
+        auto terminalFree = [&](SymbolSpan rule) {
+            for (int sym : rule) {
+                if (!nonTerminal[sym]) return false;
+            }
+            return true;
+        };
+
+        // Group the candidate alternatives by the non-terminals they use
+        for (int A : nonTerminals) {
+            for (SymbolSpan rule : productions.rule(A)) {
+                if (!terminalFree(rule)) continue;
+                for (int sym : rule) start[sym + 1]++;
+            }
+        }
+        for (int id = 0; id < symbolCount; ++id) start[id + 1] += start[id];
+        vector<uint32_t> usedIn(start.back()), fill(start.begin(), start.end() - 1);
+        for (int A : nonTerminals) {
+            for (SymbolSpan rule : productions.rule(A)) {
+                if (!terminalFree(rule)) continue;
+                for (int sym : rule) usedIn[fill[sym]++] = alternativeLhs.size();
+                alternativeLhs.push_back(A);
+                missing.push_back(rule.size());
+                if (rule.empty() && !nullable[A]) {
+                    nullable[A] = 1;
+                    worklist.push_back(A);
                 }
             }
-            if (epsilonInAll) {
-                first[symbol].insert("ε");
+        }
+
+        while (!worklist.empty()) {
+            int B = worklist.back();
+            worklist.pop_back();
+            for (uint32_t k = start[B]; k < start[B + 1]; ++k) {
+                int alternative = usedIn[k];
+                int A = alternativeLhs[alternative];
+                if (--missing[alternative] == 0 && !nullable[A]) {
+                    nullable[A] = 1;
+                    worklist.push_back(A);
+                }
             }
         }
+        return nullable;
     }
-    
-    // Helper function to compute FIRST of a string (sequence of symbols)
-    set<string> firstOfString(const vector<string>& symbols, int index) {
-        set<string> result;
-        bool epsilonInAll = true;
-        for (int i = index; i < symbols.size(); ++i) {
-            const string& sym = symbols[i];
-            if (productions.find(sym) == productions.end()) {
-                result.insert(sym);
-                epsilonInAll = false;
-                break;
-            } else {
-                result.insert(first[sym].begin(), first[sym].end());
-                if (first[sym].find("ε") == first[sym].end()) {
-                    epsilonInAll = false;
-                    break;
+
+    // Helper function to solve FIRST for one strongly connected component once
+    // every component it depends on is final. A lone non-terminal that does not
+    // lead with itself needs one pass; a cycle is iterated until it settles.
+    int solveFirstComponent(const vector<int>& members, bool cyclic) {
+        int passes = 0;
+        bool changed = true;
+        while (changed) {
+            passes++;
+            changed = false;
+            for (int A : members) {
+                for (SymbolSpan rule : productions.rule(A)) {
+                    if (addFirstOfRule(A, rule)) changed = true;
                 }
             }
+            changed = changed && cyclic;
         }
-        if (epsilonInAll) {
-            result.insert("ε");
-        }
-        return result;
+        return passes;
     }
     
-    // Helper function to add sets and return if the set changed
-    bool addSet(set<string>& dest, const set<string>& src) {
-        bool changed = false;
-        for (const string& sym : src) {
-            if (dest.insert(sym).second) {
-                changed = true;
+    // Helper function to fill the suffix rows of one alternative in a single
+    // right-to-left pass: FIRST(X β) is FIRST(X), plus FIRST(β) if X is nullable.
+    // The row past the last symbol is {ε}.
+    void fillSuffixes(uint32_t alternative) {
+        SymbolSpan rule = productions.span(productions.alternatives[alternative]);
+        uint32_t row = suffixRow[alternative] + rule.size();
+        suffixBits.clear(row);
+        suffixBits.insert(row, EPSILON_BIT);
+        for (size_t i = rule.size(); i-- > 0; ) {
+            --row;
+            int sym = rule[i];
+            suffixBits.clear(row);
+            if (!nonTerminal[sym]) {
+                suffixBits.insert(row, terminalIndex[sym]);
+                continue;
+            }
+            suffixBits.unite(row, firstBits.row(sym), false);
+            if (firstBits.test(sym, EPSILON_BIT)) suffixBits.unite(row, suffixBits.row(row + 1));
+        }
+    }
+
+    // Helper function to give every alternative its run of suffix rows and fill them
+    void computeSuffixes() {
+        suffixRow.assign(productions.alternatives.size(), 0);
+        uint32_t rows = 0;
+        for (int A : nonTerminals) {
+            Grammar::RuleView alternatives = productions.rule(A);
+            for (uint32_t k = 0; k < alternatives.size(); ++k) {
+                suffixRow[alternatives.first + k] = rows;
+                rows += alternatives[k].size() + 1;
             }
         }
-        return changed;
+        suffixBits = TerminalSets(rows, terminalSymbols.size());
+        parallelChunks(nonTerminals.size(), 256, threads, [&](size_t begin, size_t end) {
+            for (size_t n = begin; n < end; ++n) {
+                Grammar::RuleView alternatives = productions.rule(nonTerminals[n]);
+                for (uint32_t k = 0; k < alternatives.size(); ++k) fillSuffixes(alternatives.first + k);
+            }
+        });
+    }
+
+    // Helper function to add FIRST of what follows one occurrence of B (the suffix
+    // row after it) to FOLLOW(B). Returns true when that rest can vanish, so FOLLOW
+    // of the rule's left side must also flow into FOLLOW(B).
+    bool seedFollow(int B, uint32_t after, bool& changed) {
+        if (followBits.unite(B, suffixBits.row(after), false)) changed = true;
+        return suffixBits.test(after, EPSILON_BIT);
+    }
+
+    // Helper function to add FIRST of one alternative to FIRST(A) from the current sets
+    bool addFirstOfRule(int A, SymbolSpan rule) {
+        bool changed = false;
+        for (int sym : rule) {
+            if (!nonTerminal[sym]) return firstBits.insert(A, terminalIndex[sym]) || changed;
+            if (firstBits.unite(A, firstBits.row(sym), false)) changed = true;
+            if (!firstBits.test(sym, EPSILON_BIT)) return changed;
+        }
+        return firstBits.insert(A, EPSILON_BIT) || changed;
+    }
+
+    // Helper function to give terminals dense bit indices; ε keeps bit 0
+    void assignTerminalBits() {
+        terminalIndex.assign(symbols.size(), -1);
+        for (int id = 0; id < symbols.size(); ++id) {
+            if (nonTerminal[id]) continue;
+            terminalIndex[id] = terminalSymbols.size();
+            terminalSymbols.push_back(id);
+        }
+        firstBits = TerminalSets(symbols.size(), terminalSymbols.size());
+        followBits = TerminalSets(symbols.size(), terminalSymbols.size());
+    }
+
+    // Helper function to rebuild the name keyed view of a set family
+    void exportSets(const TerminalSets& sets, map<string, set<string>>& out) {
+        out.clear();
+        for (int symbol : nonTerminals) {
+            set<string>& named = out[symbols.name(symbol)];
+            sets.forEach(symbol, [&](int bit) {
+                named.insert(symbols.name(terminalSymbols[bit]));
+            });
+        }
     }
-    map<string, set<string>> firstSets;
-    map<string, set<string>> followSets;
 public:
     map<string, set<string>> first; // Stores the FIRST sets
     map<string, set<string>> follow; // Stores the FOLLOW sets
 
-    // Constructor
+    // Constructor: interns every symbol once so the computations below only see ids
     FirstFollowSet(const map<string, vector<vector<string>>>& prods, const string& start)
-        : productions(prods), startSymbol(start) {}
+        : ownGrammar(new Grammar()), productions(*ownGrammar) {
+        for (const auto& entry : prods) {
+            nonTerminals.push_back(symbols.intern(entry.first));
+        }
+        startSymbol = symbols.intern(start);
+
+        vector<int> ids;
+        for (const auto& entry : prods) {
+            int lhs = symbols.intern(entry.first);
+            for (const auto& rule : entry.second) {
+                ids.clear();
+                for (const string& sym : rule) {
+                    int id = symbols.intern(sym);
+                    if (id != EPSILON_ID) ids.push_back(id);
+                }
+                productions.addAlternative(lhs, ids);
+            }
+        }
+
+        productions.grow();
+        nonTerminal.assign(symbols.size(), false);
+        for (int symbol : nonTerminals) {
+            nonTerminal[symbol] = true;
+        }
 
-    // Function to compute all FIRST sets
+        assignTerminalBits();
+    }
+
+    // Function to compute all FIRST sets. FIRST(A) depends on FIRST(B) when B can
+    // lead an alternative of A; the strongly connected components of that graph
+    // are solved in dependency order, independent ones in parallel.
     void computeAllFirst() {
-        for (auto it = productions.begin(); it != productions.end(); ++it) {
-            const string& symbol = it->first;
-            computeFirstHelper(symbol);
+        int symbolCount = nonTerminal.size();
+        for (int symbol : nonTerminals) {
+            firstBits.clear(symbol);
+        }
+
+        vector<char> nullable = findNullable();
+        vector<vector<int>> leads(symbolCount);
+        for (int A : nonTerminals) {
+            for (SymbolSpan rule : productions.rule(A)) {
+                for (int sym : rule) {
+                    if (!nonTerminal[sym]) break;
+                    leads[A].push_back(sym);
+                    if (!nullable[sym]) break;
+                }
+            }
         }
+
+        vector<int> component;
+        int componentCount = stronglyConnectedComponents(leads, component);
+        vector<vector<int>> members(componentCount), dependents(componentCount);
+        vector<char> cyclic(componentCount, 0);
+        for (int A : nonTerminals) {
+            members[component[A]].push_back(A);
+            for (int B : leads[A]) {
+                if (component[B] != component[A]) dependents[component[B]].push_back(component[A]);
+                else cyclic[component[A]] = 1;
+            }
+        }
+        vector<int> passes(componentCount, 0);
+        runComponents(dependents, threads, [&](int c) {
+            passes[c] = solveFirstComponent(members[c], cyclic[c]);
+        });
+        solverStats.firstComponents = componentCount;
+        solverStats.firstPasses = 0;
+        for (int count : passes) solverStats.firstPasses += count;
+        computeSuffixes();
+        if (namedSets) exportSets(firstBits, first);
     }
 
-    // Function to compute all FOLLOW sets
+    // Function to compute all FOLLOW sets by building the inclusion graph
+    // FOLLOW(A) ⊆ FOLLOW(B) once, collapsing its strongly connected components
+    // and propagating each component's set in topological order (one pass).
+    // Seeding and independent components run in parallel.
     void computeAllFollow() {
+        int symbolCount = nonTerminal.size();
+        for (int symbol : nonTerminals) {
+            followBits.clear(symbol);
+        }
+        followBits.insert(startSymbol, terminalIndex[END_MARKER_ID]); // Rule 1: Add $ to the start symbol's FOLLOW set
+
+        // Every occurrence of a non-terminal, grouped by that non-terminal
+        struct Occurrence {
+            uint32_t after;  // suffix row just past the occurrence
+            int lhs;
+            bool inherits;
+        };
+        vector<uint32_t> start(symbolCount + 1, 0);
+        for (int A : nonTerminals) {
+            for (SymbolSpan rule : productions.rule(A)) {
+                for (int B : rule) {
+                    if (nonTerminal[B]) start[B + 1]++;
+                }
+            }
+        }
+        for (int id = 0; id < symbolCount; ++id) start[id + 1] += start[id];
+        vector<Occurrence> occurrences(start.back());
+        vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (int A : nonTerminals) {
+            Grammar::RuleView alternatives = productions.rule(A);
+            for (uint32_t k = 0; k < alternatives.size(); ++k) {
+                SymbolSpan rule = alternatives[k];
+                uint32_t row = suffixRow[alternatives.first + k];
+                for (size_t i = 0; i < rule.size(); ++i) {
+                    if (nonTerminal[rule[i]]) occurrences[fill[rule[i]]++] = {uint32_t(row + i + 1), A, false};
+                }
+            }
+        }
+
+        // Seed each FOLLOW(B) with the FIRST of what follows B. Only B's own task
+        // writes B's set, so non-terminals are seeded in parallel.
+        parallelChunks(nonTerminals.size(), 256, threads, [&](size_t begin, size_t end) {
+            for (size_t n = begin; n < end; ++n) {
+                int B = nonTerminals[n];
+                bool changed = false;
+                for (uint32_t o = start[B]; o < start[B + 1]; ++o) {
+                    Occurrence& at = occurrences[o];
+                    at.inherits = seedFollow(B, at.after, changed) && at.lhs != B;
+                }
+            }
+        });
+
+        // Edges A -> B for the places where FOLLOW(A) flows into FOLLOW(B)
+        vector<vector<int>> includes(symbolCount);
+        for (int B : nonTerminals) {
+            for (uint32_t o = start[B]; o < start[B + 1]; ++o) {
+                if (occurrences[o].inherits) includes[occurrences[o].lhs].push_back(B);
+            }
+        }
+
+        // Every member of a component ends up with the same FOLLOW set, the
+        // union of its members' seeds and the sets of the components flowing in
+        vector<int> component;
+        int componentCount = stronglyConnectedComponents(includes, component);
+        TerminalSets componentBits(componentCount, terminalSymbols.size());
+        vector<vector<int>> members(componentCount), dependents(componentCount);
+        for (int A : nonTerminals) {
+            members[component[A]].push_back(A);
+            for (int B : includes[A]) {
+                if (component[B] != component[A]) dependents[component[A]].push_back(component[B]);
+            }
+        }
+        solverStats.followComponents = componentCount;
+        solverStats.followSweeps = 1;
+        runComponents(dependents, threads, [&](int c) {
+            for (int B : members[c]) {
+                componentBits.unite(c, followBits.row(B));
+                for (uint32_t o = start[B]; o < start[B + 1]; ++o) {
+                    const Occurrence& at = occurrences[o];
+                    if (at.inherits && component[at.lhs] != c) componentBits.unite(c, componentBits.row(component[at.lhs]));
+                }
+            }
+            for (int B : members[c]) {
+                followBits.clear(B);
+                followBits.unite(B, componentBits.row(c));
+            }
+        });
+        if (namedSets) exportSets(followBits, follow);
+    }
+
+    // Function to compute all FOLLOW sets by sweeping the whole grammar until
+    // nothing changes (reference implementation for computeAllFollow)
+    void computeAllFollowIterative() {
         // Initialize FOLLOW sets
-        for (const auto& symbol : productions) {
-            follow[symbol.first] = set<string>();
+        for (int symbol : nonTerminals) {
+            followBits.clear(symbol);
         }
-        follow[startSymbol].insert("$"); // Rule 1: Add $ to the start symbol's FOLLOW set
+        followBits.insert(startSymbol, terminalIndex[END_MARKER_ID]); // Rule 1: Add $ to the start symbol's FOLLOW set
     
         bool changed;
+        solverStats.followComponents = 0;
+        solverStats.followSweeps = 0;
         do {
+            solverStats.followSweeps++;
             changed = false;
-            for (const auto& production : productions) {
-                const string& A = production.first;
-                const auto& rules = production.second;
-                for (const auto& rule : rules) {
+            for (int A : nonTerminals) {
+                Grammar::RuleView alternatives = productions.rule(A);
+                for (uint32_t k = 0; k < alternatives.size(); ++k) {
+                    SymbolSpan rule = alternatives[k];
+                    uint32_t row = suffixRow[alternatives.first + k];
                     for (size_t i = 0; i < rule.size(); ++i) {
-                        const string& B = rule[i];
-                        if (productions.count(B)) { // B is a non-terminal
-                            set<string> firstBeta;
-                            bool epsilonInBeta = true;
-                            if (i + 1 < rule.size()) {
-                                const string& beta = rule[i + 1];
-                                if (productions.count(beta)) {
-                                    firstBeta = first[beta];
-                                } else {
-                                    firstBeta.insert(beta);
-                                    epsilonInBeta = false;
-                                }
-                            }
-                            // Remove ε from firstBeta if it exists
-                            firstBeta.erase("ε");
-
-                            // Add firstBeta to FOLLOW(B)
-                            if (addSet(follow[B], firstBeta)) changed = true;
-                            
-                            // If ε is in firstBeta or B is the last symbol in the production
-                            if (epsilonInBeta || i + 1 >= rule.size()) {
-                                // Add FOLLOW(A) to FOLLOW(B)
-                                if (addSet(follow[B], follow[A])) changed = true;
-                            }
+                        int B = rule[i];
+                        if (nonTerminal[B] && seedFollow(B, row + i + 1, changed)) {
+                            // Add FOLLOW(A) to FOLLOW(B)
+                            if (followBits.unite(B, followBits.row(A))) changed = true;
                         }
                     }
                 }
             }
         } while (changed);
+        if (namedSets) exportSets(followBits, follow);
+    }
+
+    // Constructor for a grammar that is already interned. The grammar is used in
+    // place, not copied: it must outlive the sets, and edits to it go through
+    // replaceAlternatives. Other sets may share the grammar, so it is never
+    // compacted here; the owner compacts it before building sets.
+    FirstFollowSet(Grammar& grammar)
+        : productions(grammar), nonTerminals(grammar.nonTerminals), startSymbol(grammar.startSymbol) {
+        nonTerminal.assign(symbols.size(), false);
+        for (int symbol : nonTerminals) {
+            nonTerminal[symbol] = true;
+        }
+        assignTerminalBits();
+    }
+
+    FirstFollowSet(const FirstFollowSet&) = delete;
+    FirstFollowSet& operator=(const FirstFollowSet&) = delete;
+
+    // Function to replace the alternatives of an existing non-terminal in the
+    // grammar. Fails (and changes nothing) if the new alternatives use a symbol
+    // this set has never seen, since that needs fresh terminal bits and a full rebuild.
+    bool replaceAlternatives(int symbol, const AlternativeList& alternatives) {
+        if (!isNonTerminal(symbol) || alternatives.empty()) return false;
+        for (int sym : alternatives.symbols) {
+            if (sym <= EPSILON_ID || sym >= (int)nonTerminal.size()) return false;
+        }
+        uint32_t compactions = productions.compactions;
+        productions.setRule(symbol, alternatives);
+        if (productions.compactions != compactions) {
+            // The arena was compacted: every alternative moved
+            computeSuffixes();
+            return true;
+        }
+
+        // New alternatives get suffix rows at the end; recomputeFirst fills them
+        Grammar::RuleView added = productions.rule(symbol);
+        uint32_t rows = suffixBits.size();
+        suffixRow.resize(productions.alternatives.size());
+        for (uint32_t k = 0; k < added.size(); ++k) {
+            suffixRow[added.first + k] = rows;
+            rows += added[k].size() + 1;
+        }
+        suffixBits.resize(rows);
+        return true;
     }
+
+    // Function to recompute FIRST for a set of non-terminals that is closed under
+    // "uses in a leading position"; all other FIRST sets are taken as final. The
+    // suffix rows of the affected rules and of every rule using them are refilled.
+    void recomputeFirst(const vector<int>& affected, const vector<vector<SymbolOccurrence>>& occurrences) {
+        for (int symbol : affected) firstBits.clear(symbol);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int A : affected) {
+                for (SymbolSpan rule : productions.rule(A)) {
+                    if (addFirstOfRule(A, rule)) changed = true;
+                }
+            }
+        }
+
+        vector<char> refilled(productions.alternatives.size(), 0);
+        auto refill = [&](uint32_t alternative) {
+            if (refilled[alternative]) return;
+            refilled[alternative] = 1;
+            fillSuffixes(alternative);
+        };
+        for (int A : affected) {
+            Grammar::RuleView alternatives = productions.rule(A);
+            for (uint32_t k = 0; k < alternatives.size(); ++k) refill(alternatives.first + k);
+            for (const SymbolOccurrence& at : occurrences[A]) refill(productions.rule(at.lhs).first + at.alternative);
+        }
+    }
+
+    // Function to recompute FOLLOW for a set of non-terminals that is closed under
+    // FOLLOW inclusion, using every place each of them occurs in the grammar
+    void recomputeFollow(const vector<int>& affected, const vector<vector<SymbolOccurrence>>& occurrences) {
+        for (int symbol : affected) followBits.clear(symbol);
+        followBits.insert(startSymbol, terminalIndex[END_MARKER_ID]);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int B : affected) {
+                for (const SymbolOccurrence& at : occurrences[B]) {
+                    uint32_t after = suffixAt(at.lhs, at.alternative, at.position + 1);
+                    if (seedFollow(B, after, changed) && followBits.unite(B, followBits.row(at.lhs))) {
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Function to install FIRST/FOLLOW bits computed earlier (for example by a cached run).
+    // Fails if the bit layout does not match this grammar or a bit past the last terminal is set.
+    bool restoreSets(const vector<uint64_t>& firstWords, const vector<uint64_t>& followWords) {
+        if (firstWords.size() != firstBits.raw().size() || followWords.size() != followBits.raw().size()) return false;
+        int words = firstBits.words(), spare = terminalCount() % 64;
+        uint64_t unused = spare ? ~0ULL << spare : 0;
+        for (const vector<uint64_t>* sets : {&firstWords, &followWords}) {
+            for (size_t last = words - 1; last < sets->size(); last += words) {
+                if ((*sets)[last] & unused) return false;
+            }
+        }
+        firstBits.raw() = firstWords;
+        followBits.raw() = followWords;
+        computeSuffixes();
+        exportNamedSets();
+        return true;
+    }
+
+    // Function to refresh the name keyed first/follow maps after partial recomputation
+    void exportNamedSets() {
+        exportSets(firstBits, first);
+        exportSets(followBits, follow);
+    }
+
+    // Function to get the suffix row for position i of the k-th alternative of a non-terminal
+    uint32_t suffixAt(int symbol, int k, size_t i) const {
+        return suffixRow[productions.rule(symbol).first + k] + i;
+    }
+
+    // Function to tell whether FOLLOW of a rule's left side flows into FOLLOW(rule[i]),
+    // that is whether everything after position i of the k-th alternative is nullable
+    bool inheritsFollow(int symbol, int k, size_t i) const {
+        return suffixBits.test(suffixAt(symbol, k, i + 1), EPSILON_BIT);
+    }
+
+    // Function to set the worker count for computeAllFirst/computeAllFollow
+    void setThreads(int count) { threads = count; }
+
+    // Function to skip filling the name keyed maps, for callers that only read the
+    // bit sets (exportNamedSets fills them on demand)
+    void setNamedSets(bool keep) { namedSets = keep; }
+
+    // Id based accessors for later pipeline stages
+    const SymbolTable& getSymbols() const { return symbols; }
+    const vector<int>& getNonTerminals() const { return nonTerminals; }
+    int getStartSymbol() const { return startSymbol; }
+    Grammar::RuleView alternatives(int symbol) const { return productions.rule(symbol); }
+    bool isNonTerminal(int symbol) const { return symbol < (int)nonTerminal.size() && nonTerminal[symbol]; }
+    int terminalCount() const { return terminalSymbols.size(); }
+    int terminalBit(int symbol) const { return terminalIndex[symbol]; }
+    int terminalAt(int bit) const { return terminalSymbols[bit]; }
+    const TerminalSets& firstSets() const { return firstBits; }
+    const TerminalSets& followSets() const { return followBits; }
+    const TerminalSets& suffixSets() const { return suffixBits; }
+    const SetSolverStats& stats() const { return solverStats; }
     
     // Function to print FIRST sets
     void printFirstSets() {
@@ -202,11 +612,11 @@ void saveFollowSetsToFile(const string& filename) {
 
 // Add these inside FirstFollowSet class
 const map<string, set<string>>& getFirstSets() const {
-    return firstSets;
+    return first;
 }
 
 const map<string, set<string>>& getFollowSets() const {
-    return followSets;
+    return follow;
 }
 
 };
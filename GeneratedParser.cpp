@@ -0,0 +1,141 @@
+// Generated from an LL(1) parse table. Do not edit.
+// Start symbol: E
+
+#pragma once
+#include <cstddef>
+
+class DirectParser {
+private:
+    const int* tokens = nullptr;
+    size_t count = 0;
+    size_t position = 0;
+    size_t depthLimit;
+    bool tooDeep = false;
+
+    int peek() const { return position < count ? tokens[position] : 1; }
+
+    bool match(int terminal) {
+        if (peek() != terminal) return false;
+        ++position;
+        return true;
+    }
+
+    bool nestedTooDeep() {
+        tooDeep = true;
+        return false;
+    }
+
+    // E
+    bool parse_E_0(size_t depth) {
+        if (depth > depthLimit) return nestedTooDeep();
+        switch (peek()) {
+        case 9:  // id
+        case 10:  // (
+            // E -> T A
+            if (!parse_T_2(depth + 1)) return false;
+            if (!parse_A_1(depth + 1)) return false;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // A
+    bool parse_A_1(size_t depth) {
+        if (depth > depthLimit) return nestedTooDeep();
+        for (;;) {
+            switch (peek()) {
+            case 1:  // $
+            case 11:  // )
+                // A -> ε
+                return true;
+            case 5:  // +
+                // A -> + T A
+                if (!match(5)) return false;  // +
+                if (!parse_T_2(depth + 1)) return false;
+                continue;
+            default:
+                return false;
+            }
+        }
+    }
+
+    // T
+    bool parse_T_2(size_t depth) {
+        if (depth > depthLimit) return nestedTooDeep();
+        switch (peek()) {
+        case 9:  // id
+        case 10:  // (
+            // T -> F B
+            if (!parse_F_4(depth + 1)) return false;
+            if (!parse_B_3(depth + 1)) return false;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // B
+    bool parse_B_3(size_t depth) {
+        if (depth > depthLimit) return nestedTooDeep();
+        for (;;) {
+            switch (peek()) {
+            case 1:  // $
+            case 5:  // +
+            case 11:  // )
+                // B -> ε
+                return true;
+            case 8:  // *
+                // B -> * F B
+                if (!match(8)) return false;  // *
+                if (!parse_F_4(depth + 1)) return false;
+                continue;
+            default:
+                return false;
+            }
+        }
+    }
+
+    // F
+    bool parse_F_4(size_t depth) {
+        if (depth > depthLimit) return nestedTooDeep();
+        switch (peek()) {
+        case 9:  // id
+            // F -> id
+            if (!match(9)) return false;  // id
+            return true;
+        case 10:  // (
+            // F -> ( E )
+            if (!match(10)) return false;  // (
+            if (!parse_E_0(depth + 1)) return false;
+            if (!match(11)) return false;  // )
+            return true;
+        default:
+            return false;
+        }
+    }
+
+public:
+    static const int symbolCount = 12;
+
+    // Constructor: input nested deeper than depthLimit non-terminal calls is rejected
+    explicit DirectParser(size_t limit = 10000) : depthLimit(limit) {}
+
+    // Function to tell whether the last input was rejected for nesting too deeply
+    bool exceededDepth() const { return tooDeep; }
+
+    // Symbol names by id, to check the parser against the table it came from
+    static const char* symbolName(int id) {
+        static const char* const names[] = {"ε", "$", "E", "T", "A", "+", "F", "B", "*", "id", "(", ")"};
+        return names[id];
+    }
+
+    // Function to parse a complete token sequence
+    bool parse(const int* input, size_t length) {
+        tokens = input;
+        count = length;
+        position = 0;
+        tooDeep = false;
+        return parse_E_0(1) && position == count;
+    }
+};
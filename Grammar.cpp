@@ -0,0 +1,301 @@
+// Grammar held as symbol ids: every alternative is a span of one contiguous
+// arena of symbol ids, shared by every transformation pass
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sstream>
+#include <ostream>
+#include <algorithm>
+#include "SymbolTable.cpp"
+using namespace std;
+
+// Read-only span of symbol ids. Spans into a Grammar are invalidated by any
+// change to that grammar.
+struct SymbolSpan {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    SymbolSpan() {}
+    SymbolSpan(const int* from, const int* to) : first(from), last(to) {}
+    SymbolSpan(const vector<int>& symbols) : first(symbols.data()), last(symbols.data() + symbols.size()) {}
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    int operator[](size_t i) const { return first[i]; }
+    int back() const { return last[-1]; }
+
+    bool operator==(const SymbolSpan& other) const {
+        return size() == other.size() && equal(first, last, other.first);
+    }
+};
+
+// Function to hash a span of symbol ids (64-bit FNV-1a over the ids)
+uint64_t spanHash(SymbolSpan span) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int symbol : span) {
+        hash ^= (uint32_t)symbol;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Alternatives being assembled for one rule, kept flat so a pass can build a
+// whole rule without allocating per alternative. The last alternative is open
+// for push() until close() ends it.
+struct AlternativeList {
+    vector<int> symbols;
+    vector<uint32_t> starts = {0};
+
+    size_t size() const { return starts.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    SymbolSpan operator[](size_t i) const {
+        return SymbolSpan(symbols.data() + starts[i], symbols.data() + starts[i + 1]);
+    }
+
+    void clear() {
+        symbols.clear();
+        starts.assign(1, 0);
+    }
+
+    void push(int symbol) { symbols.push_back(symbol); }
+    void close() { starts.push_back(symbols.size()); }
+
+    void add(SymbolSpan span) {
+        symbols.insert(symbols.end(), span.begin(), span.end());
+        close();
+    }
+
+    // Function to drop repeated alternatives, keeping the first of each
+    void removeDuplicates() {
+        size_t slots = 16;
+        while (slots < size() * 2) slots *= 2;
+        vector<uint32_t> seen(slots, UINT32_MAX);
+        AlternativeList unique;
+        unique.symbols.reserve(symbols.size());
+        unique.starts.reserve(starts.size());
+        for (size_t i = 0; i < size(); ++i) {
+            size_t slot = spanHash((*this)[i]) & (slots - 1);
+            while (seen[slot] != UINT32_MAX && !(unique[seen[slot]] == (*this)[i])) slot = (slot + 1) & (slots - 1);
+            if (seen[slot] != UINT32_MAX) continue;
+            seen[slot] = unique.size();
+            unique.add((*this)[i]);
+        }
+        if (unique.size() != size()) swap(unique);
+    }
+
+    void swap(AlternativeList& other) {
+        symbols.swap(other.symbols);
+        starts.swap(other.starts);
+    }
+};
+
+struct Grammar {
+    struct Alternative {
+        uint32_t start = 0;   // first symbol in arena
+        uint32_t length = 0;
+    };
+    struct Rule {
+        uint32_t first = 0;   // first entry in alternatives
+        uint32_t count = 0;
+    };
+
+    SymbolTable symbols;
+    int startSymbol = -1;
+    vector<int> nonTerminals;             // non-terminal ids in first-seen order
+    vector<int> arena;                    // symbol ids of every alternative back to back (ε is empty)
+    vector<Alternative> alternatives;     // the alternatives of one rule are a contiguous run
+    vector<Rule> rules;                   // symbol id -> its run of alternatives
+    size_t deadSymbols = 0;               // arena entries no rule refers to any more
+    size_t deadAlternatives = 0;
+    uint32_t compactions = 0;             // bumped whenever compact() moves the alternatives
+
+    // Iterable view of one rule's alternatives
+    struct RuleView {
+        const Grammar* grammar;
+        uint32_t first;
+        uint32_t count;
+
+        struct iterator {
+            const Grammar* grammar;
+            uint32_t index;
+            SymbolSpan operator*() const { return grammar->span(grammar->alternatives[index]); }
+            iterator& operator++() { ++index; return *this; }
+            bool operator!=(const iterator& other) const { return index != other.index; }
+        };
+
+        iterator begin() const { return {grammar, first}; }
+        iterator end() const { return {grammar, first + count}; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        SymbolSpan operator[](size_t i) const { return grammar->span(grammar->alternatives[first + i]); }
+    };
+
+    SymbolSpan span(const Alternative& alternative) const {
+        const int* base = arena.data() + alternative.start;
+        return SymbolSpan(base, base + alternative.length);
+    }
+
+    bool isNonTerminal(int symbol) const {
+        return symbol < (int)rules.size() && rules[symbol].count > 0;
+    }
+
+    RuleView rule(int symbol) const {
+        if (symbol >= (int)rules.size()) return {this, 0, 0};
+        return {this, rules[symbol].first, rules[symbol].count};
+    }
+
+    SymbolSpan alternative(int symbol, int index) const {
+        return span(alternatives[rules[symbol].first + index]);
+    }
+
+    // Function to make sure the rule table covers every interned symbol
+    void grow() {
+        if ((int)rules.size() < symbols.size()) rules.resize(symbols.size());
+    }
+
+    // Function to add an alternative to a non-terminal, registering it on first use.
+    // The span must not point into this grammar's own arena. Adding to a rule that is
+    // not the last one moves its run, so interleaved rules go through addAlternatives.
+    void addAlternative(int lhs, SymbolSpan rhs) {
+        grow();
+        Rule& rule = rules[lhs];
+        if (rule.count == 0) {
+            nonTerminals.push_back(lhs);
+            rule.first = alternatives.size();
+        } else if (rule.first + rule.count != alternatives.size()) {
+            // Another rule grew since: move this rule's run to the end
+            for (uint32_t i = 0; i < rule.count; ++i) alternatives.push_back(alternatives[rule.first + i]);
+            deadAlternatives += rule.count;
+            rule.first = alternatives.size() - rule.count;
+        }
+        alternatives.push_back({(uint32_t)arena.size(), (uint32_t)rhs.size()});
+        arena.insert(arena.end(), rhs.begin(), rhs.end());
+        rule.count++;
+    }
+
+    // Function to add alternatives given in any order, such as source order, where
+    // lhs[i] is the left side of list[i]. They are grouped by left side first, so
+    // each rule's run is laid out once however the rules interleave.
+    void addAlternatives(const vector<int>& lhs, const AlternativeList& list) {
+        grow();
+        vector<uint32_t> added(rules.size(), 0), next(rules.size(), UINT32_MAX);
+        for (int symbol : lhs) added[symbol]++;
+        alternatives.reserve(alternatives.size() + list.size());
+        for (int symbol : lhs) {
+            if (next[symbol] != UINT32_MAX) continue;
+            Rule& rule = rules[symbol];
+            if (rule.count == 0) {
+                nonTerminals.push_back(symbol);
+            } else if (rule.first + rule.count != alternatives.size()) {
+                for (uint32_t i = 0; i < rule.count; ++i) alternatives.push_back(alternatives[rule.first + i]);
+                deadAlternatives += rule.count;
+            }
+            rule.first = alternatives.size() - rule.count;
+            next[symbol] = alternatives.size();
+            alternatives.resize(alternatives.size() + added[symbol]);
+            rule.count += added[symbol];
+        }
+        arena.reserve(arena.size() + list.symbols.size());
+        for (size_t i = 0; i < list.size(); ++i) {
+            SymbolSpan rhs = list[i];
+            alternatives[next[lhs[i]]++] = {(uint32_t)arena.size(), (uint32_t)rhs.size()};
+            arena.insert(arena.end(), rhs.begin(), rhs.end());
+        }
+    }
+
+    // Function to replace the alternatives of a symbol; does not register new non-terminals
+    void setRule(int lhs, const AlternativeList& list) {
+        grow();
+        Rule& rule = rules[lhs];
+        for (uint32_t i = 0; i < rule.count; ++i) deadSymbols += alternatives[rule.first + i].length;
+        deadAlternatives += rule.count;
+
+        rule.first = alternatives.size();
+        rule.count = list.size();
+        for (size_t i = 0; i < list.size(); ++i) {
+            SymbolSpan rhs = list[i];
+            alternatives.push_back({(uint32_t)arena.size(), (uint32_t)rhs.size()});
+            arena.insert(arena.end(), rhs.begin(), rhs.end());
+        }
+        if (deadSymbols > arena.size() / 2 + 1024 || deadAlternatives > alternatives.size() / 2 + 1024) compact();
+    }
+
+    // Function to copy the live rules into a fresh arena in symbol order
+    void compact() {
+        vector<int> packed;
+        vector<Alternative> packedAlternatives;
+        packed.reserve(arena.size() - deadSymbols);
+        packedAlternatives.reserve(alternatives.size() - deadAlternatives);
+        for (Rule& rule : rules) {
+            uint32_t first = packedAlternatives.size();
+            for (uint32_t i = 0; i < rule.count; ++i) {
+                SymbolSpan rhs = span(alternatives[rule.first + i]);
+                packedAlternatives.push_back({(uint32_t)packed.size(), (uint32_t)rhs.size()});
+                packed.insert(packed.end(), rhs.begin(), rhs.end());
+            }
+            rule.first = first;
+        }
+        arena.swap(packed);
+        alternatives.swap(packedAlternatives);
+        deadSymbols = deadAlternatives = 0;
+        compactions++;
+    }
+
+    // Function to create a fresh non-terminal, priming the name until it is unused
+    int freshNonTerminal(string name) {
+        while (symbols.find(name) != -1) name += "'";
+        int id = symbols.intern(name);
+        grow();
+        return id;
+    }
+
+    // Function to format one alternative as space separated names
+    string alternativeText(SymbolSpan rhs) const {
+        if (rhs.empty()) return "ε";
+        string text;
+        for (size_t i = 0; i < rhs.size(); ++i) {
+            if (i) text += " ";
+            text += symbols.name(rhs[i]);
+        }
+        return text;
+    }
+};
+
+// Function to build a grammar from parallel lhs/rhs lists such as readCFGFromFile produces
+Grammar grammarFromProductions(const vector<string>& left_production, const vector<string>& right_production) {
+    Grammar grammar;
+    vector<int> lhs;
+    AlternativeList alternatives;
+    for (size_t i = 0; i < left_production.size(); ++i) {
+        lhs.push_back(grammar.symbols.intern(left_production[i]));
+        if (grammar.startSymbol < 0) grammar.startSymbol = lhs.back();
+
+        stringstream ss(right_production[i]);
+        string token;
+        while (ss >> token) {
+            int id = grammar.symbols.intern(token);
+            if (id != EPSILON_ID) alternatives.push(id);
+        }
+        alternatives.close();
+    }
+    grammar.addAlternatives(lhs, alternatives);
+    return grammar;
+}
+
+// Function to write a grammar as "A -> x y | z" lines in non-terminal order
+void writeGrammar(const Grammar& grammar, ostream& out) {
+    for (int nonTerminal : grammar.nonTerminals) {
+        out << grammar.symbols.name(nonTerminal) << " -> ";
+        Grammar::RuleView alternatives = grammar.rule(nonTerminal);
+        for (size_t i = 0; i < alternatives.size(); ++i) {
+            out << grammar.alternativeText(alternatives[i]);
+            if (i < alternatives.size() - 1) out << " | ";
+        }
+        out << endl;
+    }
+}
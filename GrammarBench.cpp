@@ -0,0 +1,292 @@
+// Benchmark of the grammar pipeline on generated grammars: times every stage
+// and records the results as JSON so runs on different commits can be compared.
+//
+//   g++ -std=c++17 -O2 -pthread GrammarBench.cpp -o grammarbench
+//   grammarbench [--json results.json] [--label TEXT] [--repeat N] [--threads N] [--seed S] [--scale F]
+//                [--keep-grammar DIR]
+//
+// follow_graph and follow_iterative time the inclusion-graph FOLLOW solver
+// (computeAllFollow) and its reference (computeAllFollowIterative) alone on the
+// grammar first_follow saw; they are not part of the pipeline total. Their ratio is
+// reported as follow_speedup, with the sweeps the reference needed.
+//
+// Without scenario options the standard suite runs. Any of --nonterminals N,
+// --terminals N, --alternatives N, --length N, --prefix PERCENT, --recursion DEPTH,
+// --nullable LENGTH, --stride N runs a single "custom" scenario instead.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include "Pipeline.cpp"
+#include "GrammarGenerator.cpp"
+
+using namespace std;
+
+struct BenchScenario {
+    string name;
+    GeneratorOptions grammar;
+};
+
+const vector<string> BENCH_STAGES = {"load",         "factor",           "left_recursion", "first_follow",
+                                     "follow_graph", "follow_iterative", "table"};
+
+// Function to tell whether a stage times a solver on its own rather than a pipeline stage
+bool isSolverStage(const string& stage) {
+    return stage == "follow_graph" || stage == "follow_iterative";
+}
+
+struct BenchResult {
+    BenchScenario scenario;
+    size_t bytes = 0;
+    size_t productions = 0;
+    int nonTerminals = 0;
+    int terminals = 0;
+    int factored = 0;
+    int recursion = 0;
+    size_t conflicts = 0;
+    int followComponents = 0;             // components of the FOLLOW inclusion graph
+    int followSweeps = 0;                 // passes computeAllFollowIterative made
+    vector<vector<double>> milliseconds;  // stage -> one time per repeat
+};
+
+// Function to list the standard scenarios, each stressing one stage at the given scale
+vector<BenchScenario> standardSuite(double scale) {
+    auto scaled = [&](int n) { return max(10, (int)(n * scale)); };
+    vector<BenchScenario> suite(5);
+    suite[0].name = "baseline";
+    suite[0].grammar.nonTerminals = scaled(5000);
+
+    suite[1].name = "shared_prefixes";
+    suite[1].grammar.nonTerminals = scaled(5000);
+    suite[1].grammar.alternatives = 8;
+    suite[1].grammar.sharedPrefix = 70;
+
+    suite[2].name = "left_recursion";
+    suite[2].grammar.nonTerminals = scaled(5000);
+    suite[2].grammar.recursionDepth = 8;
+    suite[2].grammar.stride = 2;
+
+    suite[3].name = "nullable_chains";
+    suite[3].grammar.nonTerminals = scaled(5000);
+    suite[3].grammar.nullableChain = 6;
+    suite[3].grammar.stride = 2;
+
+    suite[4].name = "large_mixed";
+    suite[4].grammar.nonTerminals = scaled(10000);  // stays under the 16-bit production limit
+    suite[4].grammar.terminals = 128;
+    suite[4].grammar.sharedPrefix = 25;
+    suite[4].grammar.recursionDepth = 3;
+    suite[4].grammar.nullableChain = 3;
+
+    // FOLLOW depth sweep: longer recursion cycles and nullable chains make the
+    // reference solver sweep more often, while first_follow stays one pass
+    for (int depth : {1, 4, 16, 64}) {
+        BenchScenario scenario;
+        scenario.name = "follow_depth_" + to_string(depth);
+        scenario.grammar.nonTerminals = scaled(5000);
+        scenario.grammar.recursionDepth = depth;
+        scenario.grammar.nullableChain = depth;
+        scenario.grammar.stride = 2;
+        suite.push_back(scenario);
+    }
+    return suite;
+}
+
+// Function to run the pipeline stage by stage on one generated grammar, repeat times
+bool runScenario(const BenchScenario& scenario, int repeat, int threads, const string& directory, BenchResult& result) {
+    string path = (filesystem::path(directory) / (scenario.name + ".txt")).string();
+    {
+        ofstream file(path, ios::binary);
+        if (!file) {
+            cerr << "Error: Unable to write " << path << endl;
+            return false;
+        }
+        generateGrammar(scenario.grammar, file);
+    }
+
+    result.scenario = scenario;
+    result.bytes = filesystem::file_size(path);
+    result.milliseconds.assign(BENCH_STAGES.size(), vector<double>());
+    PipelineOptions options;
+    options.threads = threads;
+    for (int r = 0; r < repeat; ++r) {
+        GrammarPipeline pipeline(options);
+        int stage = 0;
+        auto timed = [&](auto run) {
+            auto start = chrono::steady_clock::now();
+            bool ok = run();
+            result.milliseconds[stage++].push_back(
+                chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+            return ok;
+        };
+        if (!timed([&] { return pipeline.load(path); })) {
+            cerr << "Error: No productions read from " << path << endl;
+            return false;
+        }
+        timed([&] { pipeline.factor(); return true; });
+        timed([&] { pipeline.removeLeftRecursion(); return true; });
+        timed([&] { pipeline.computeSets(); return true; });
+        FirstFollowSet reference(pipeline.grammar);
+        reference.setNamedSets(false);
+        reference.computeAllFirst();
+        timed([&] { reference.computeAllFollow(); return true; });
+        result.followComponents = reference.stats().followComponents;
+        timed([&] { reference.computeAllFollowIterative(); return true; });
+        result.followSweeps = reference.stats().followSweeps;
+        if (!timed([&] { return pipeline.buildTable(); })) return false;
+
+        result.productions = pipeline.source.productions.size();
+        result.nonTerminals = pipeline.grammar.nonTerminals.size();
+        result.terminals = pipeline.sets->terminalCount();
+        result.factored = pipeline.factoredNonTerminals;
+        result.recursion = pipeline.recursionNonTerminals;
+        result.conflicts = pipeline.table.conflicts.size();
+    }
+    return true;
+}
+
+// Helper functions for the summary statistics of one stage
+double bestOf(const vector<double>& times) {
+    return *min_element(times.begin(), times.end());
+}
+
+double medianOf(vector<double> times) {
+    sort(times.begin(), times.end());
+    size_t middle = times.size() / 2;
+    return times.size() % 2 ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+}
+
+// Function to get how many times faster the inclusion-graph FOLLOW solver ran than the reference
+double followSpeedup(const BenchResult& result) {
+    size_t graph = find(BENCH_STAGES.begin(), BENCH_STAGES.end(), "follow_graph") - BENCH_STAGES.begin();
+    size_t iterative = find(BENCH_STAGES.begin(), BENCH_STAGES.end(), "follow_iterative") - BENCH_STAGES.begin();
+    double graphMs = medianOf(result.milliseconds[graph]);
+    return graphMs > 0 ? medianOf(result.milliseconds[iterative]) / graphMs : 0;
+}
+
+// Function to write every result as one JSON document
+void writeBenchJson(ostream& out, const string& label, int repeat, int threads, const vector<BenchResult>& results) {
+    out << "{\n  \"label\": " << jsonString(label) << ",\n  \"repeat\": " << repeat << ",\n  \"threads\": " << threads
+        << ",\n  \"scenarios\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        const GeneratorOptions& g = result.scenario.grammar;
+        out << (i ? "," : "") << "\n    {\n      \"name\": " << jsonString(result.scenario.name) << ",\n"
+            << "      \"generator\": {\"seed\": " << g.seed << ", \"nonTerminals\": " << g.nonTerminals
+            << ", \"terminals\": " << g.terminals << ", \"alternatives\": " << g.alternatives
+            << ", \"maxLength\": " << g.maxLength << ", \"sharedPrefix\": " << g.sharedPrefix
+            << ", \"recursionDepth\": " << g.recursionDepth << ", \"nullableChain\": " << g.nullableChain
+            << ", \"stride\": " << g.stride << "},\n"
+            << "      \"grammar\": {\"bytes\": " << result.bytes << ", \"productions\": " << result.productions
+            << ", \"nonTerminals\": " << result.nonTerminals << ", \"terminals\": " << result.terminals
+            << ", \"factoredNonTerminals\": " << result.factored << ", \"recursionNonTerminals\": " << result.recursion
+            << ", \"conflicts\": " << result.conflicts << "},\n      \"stages\": {";
+        double total = 0;
+        for (size_t s = 0; s < BENCH_STAGES.size(); ++s) {
+            const vector<double>& times = result.milliseconds[s];
+            if (!isSolverStage(BENCH_STAGES[s])) total += medianOf(times);
+            out << (s ? ", " : "") << "\n        " << jsonString(BENCH_STAGES[s]) << ": {\"best_ms\": " << bestOf(times)
+                << ", \"median_ms\": " << medianOf(times) << ", \"runs_ms\": [";
+            for (size_t r = 0; r < times.size(); ++r) out << (r ? ", " : "") << times[r];
+            out << "]}";
+        }
+        out << "\n      },\n      \"total_median_ms\": " << total << ",\n      \"follow_speedup\": " << followSpeedup(result)
+            << ", \"follow_components\": " << result.followComponents << ", \"follow_sweeps\": " << result.followSweeps
+            << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// Function to print one line per scenario with the median time of every stage
+void printBenchTable(const vector<BenchResult>& results) {
+    cout << left;
+    cout.width(18);
+    cout << "scenario";
+    cout << right;
+    for (const string& stage : BENCH_STAGES) {
+        cout.width(18);
+        cout << stage;
+    }
+    cout << "     productions  follow speedup (sweeps)  (median ms)\n";
+    for (const BenchResult& result : results) {
+        cout << left;
+        cout.width(18);
+        cout << result.scenario.name << right;
+        for (const auto& times : result.milliseconds) {
+            cout.width(18);
+            cout << medianOf(times);
+        }
+        cout.width(16);
+        cout << result.productions;
+        cout.width(15);
+        cout << followSpeedup(result) << "x (" << result.followSweeps << ")\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string jsonFile, label, keepDirectory;
+    int repeat = 3, threads = 1;
+    double scale = 1;
+    uint64_t seed = 1;
+    BenchScenario custom;
+    custom.name = "custom";
+    bool useCustom = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json" && hasValue) jsonFile = argv[++i];
+        else if (arg == "--label" && hasValue) label = argv[++i];
+        else if (arg == "--repeat" && hasValue) repeat = max(1, stoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) threads = stoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = stoull(argv[++i]);
+        else if (arg == "--scale" && hasValue) scale = stod(argv[++i]);
+        else if (arg == "--keep-grammar" && hasValue) keepDirectory = argv[++i];
+        else if (arg == "--nonterminals" && hasValue) useCustom = true, custom.grammar.nonTerminals = stoi(argv[++i]);
+        else if (arg == "--terminals" && hasValue) useCustom = true, custom.grammar.terminals = stoi(argv[++i]);
+        else if (arg == "--alternatives" && hasValue) useCustom = true, custom.grammar.alternatives = stoi(argv[++i]);
+        else if (arg == "--length" && hasValue) useCustom = true, custom.grammar.maxLength = stoi(argv[++i]);
+        else if (arg == "--prefix" && hasValue) useCustom = true, custom.grammar.sharedPrefix = stoi(argv[++i]);
+        else if (arg == "--recursion" && hasValue) useCustom = true, custom.grammar.recursionDepth = stoi(argv[++i]);
+        else if (arg == "--nullable" && hasValue) useCustom = true, custom.grammar.nullableChain = stoi(argv[++i]);
+        else if (arg == "--stride" && hasValue) useCustom = true, custom.grammar.stride = stoi(argv[++i]);
+        else {
+            cerr << "Error: unknown option " << arg << endl;
+            return 1;
+        }
+    }
+
+    vector<BenchScenario> scenarios = useCustom ? vector<BenchScenario>{custom} : standardSuite(scale);
+    for (BenchScenario& scenario : scenarios) scenario.grammar.seed = seed;
+
+    // Generated grammars go to a scratch directory unless they should be kept
+    error_code ignored;
+    string directory = keepDirectory;
+    if (directory.empty()) directory = (filesystem::temp_directory_path() / ("grammarbench-" + to_string(seed))).string();
+    filesystem::create_directories(directory, ignored);
+
+    vector<BenchResult> results;
+    for (const BenchScenario& scenario : scenarios) {
+        cerr << "Running " << scenario.name << "..." << endl;
+        BenchResult result;
+        if (!runScenario(scenario, repeat, threads, directory, result)) return 1;
+        results.push_back(result);
+    }
+    if (keepDirectory.empty()) filesystem::remove_all(directory, ignored);
+
+    printBenchTable(results);
+    if (!jsonFile.empty()) {
+        ofstream out(jsonFile);
+        if (!out) {
+            cerr << "Error: Unable to write " << jsonFile << endl;
+            return 1;
+        }
+        writeBenchJson(out, label, repeat, threads, results);
+        cout << "Results saved to: " << jsonFile << endl;
+    }
+    return 0;
+}
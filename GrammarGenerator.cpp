@@ -0,0 +1,118 @@
+// Seeded generator of large synthetic grammars for benchmarking the pipeline.
+// Every knob stresses one stage: shared prefixes feed left factoring, left
+// recursion cycles feed eliminateLeftRecursion and nullable chains feed FOLLOW.
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <algorithm>
+using namespace std;
+
+struct GeneratorOptions {
+    uint64_t seed = 1;
+    int nonTerminals = 1000;     // N0 .. N(n-1); N0 is the start symbol
+    int terminals = 64;          // t0 .. t(k-1)
+    int alternatives = 4;        // base alternatives per non-terminal
+    int maxLength = 5;           // symbols per base alternative (at least 1)
+    int sharedPrefix = 0;        // percent of base alternatives that start with a shared prefix
+    int recursionDepth = 0;      // length of each left recursion cycle (1: direct, 0: none)
+    int nullableChain = 0;       // length of each run of nullable non-terminals (0: none)
+    int stride = 8;              // one cycle and one chain start per stride * length non-terminals
+};
+
+// Small self-contained PRNG (splitmix64) so a seed gives the same grammar everywhere
+class GrammarRandom {
+private:
+    uint64_t state;
+
+public:
+    GrammarRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Function to draw a number in [0, bound)
+    int below(int bound) {
+        return bound <= 1 ? 0 : next() % bound;
+    }
+};
+
+// Function to write a generated grammar as "A -> x y | z" lines. Base alternatives
+// lead with a terminal or a later non-terminal, so the only left recursion is the
+// one the options ask for.
+void generateGrammar(const GeneratorOptions& options, ostream& out) {
+    GrammarRandom random(options.seed);
+    int n = options.nonTerminals < 1 ? 1 : options.nonTerminals;
+    int k = options.terminals < 1 ? 1 : options.terminals;
+    auto nonTerminal = [](int i) { return "N" + to_string(i); };
+    auto terminal = [](int i) { return "t" + to_string(i); };
+
+    vector<vector<string>> rules(n);
+    vector<string> prefixes(n);
+    for (int i = 0; i < n; ++i) {
+        // Each non-terminal has its own prefix, so factoring creates per-rule helpers
+        prefixes[i] = terminal(random.below(k));
+        for (int p = random.below(3); p > 0; --p) {
+            prefixes[i] += " " + (i + 1 < n && random.below(2) ? nonTerminal(i + 1 + random.below(n - i - 1))
+                                                                 : terminal(random.below(k)));
+        }
+
+        for (int a = 0; a < options.alternatives; ++a) {
+            string alternative;
+            if (random.below(100) < options.sharedPrefix) alternative = prefixes[i] + " ";
+            int length = 1 + random.below(options.maxLength < 1 ? 1 : options.maxLength);
+            bool leadsWithNonTerminal = false;
+            for (int s = 0; s < length; ++s) {
+                // A terminal right after a leading non-terminal keeps a nullable one
+                // from exposing an earlier non-terminal in leading position
+                bool leading = s == 0 && alternative.empty();
+                bool useNonTerminal = random.below(100) < 35;
+                if ((leading && i + 1 >= n) || (s == 1 && leadsWithNonTerminal)) useNonTerminal = false;
+                if (!useNonTerminal) alternative += terminal(random.below(k));
+                else if (leading) alternative += nonTerminal(i + 1 + random.below(n - i - 1));
+                else alternative += nonTerminal(random.below(n));
+                leadsWithNonTerminal = leadsWithNonTerminal || (leading && useNonTerminal);
+                if (s + 1 < length) alternative += " ";
+            }
+            rules[i].push_back(alternative);
+        }
+    }
+
+    // Left recursion: N(i) -> N(i+1) x, ..., N(i+d-1) -> N(i) y
+    int depth = options.recursionDepth;
+    if (depth > 0 && depth <= n) {
+        int stride = max(1, options.stride) * depth;
+        for (int i = 0; i + depth <= n; i += stride) {
+            for (int j = 0; j < depth; ++j) {
+                int next = j + 1 < depth ? i + j + 1 : i;
+                rules[i + j].push_back(nonTerminal(next) + " " + terminal(random.below(k)));
+            }
+        }
+    }
+
+    // Nullable chains: N(i) .. N(i+c-1) may vanish and are used back to back
+    int chain = options.nullableChain;
+    if (chain > 0 && chain < n) {
+        int stride = max(1, options.stride) * chain;
+        for (int i = 1; i + chain <= n; i += stride) {
+            string run;
+            for (int j = 0; j < chain; ++j) {
+                rules[i + j].push_back("ε");
+                run += " " + nonTerminal(i + j);
+            }
+            rules[i - 1].push_back(terminal(random.below(k)) + run + " " + terminal(random.below(k)));
+        }
+    }
+
+    for (int i = 0; i < n; ++i) {
+        out << nonTerminal(i) << " ->";
+        for (size_t a = 0; a < rules[i].size(); ++a) out << (a ? " | " : " ") << rules[i][a];
+        out << "\n";
+    }
+}
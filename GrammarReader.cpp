@@ -0,0 +1,314 @@
+// Fast grammar file reader: the file is mapped once, a lexer hands out
+// string_view tokens for the "A -> α | β" notation (→ works as well as ->),
+// and every production is stored as a span of one contiguous token arena
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+#include "MappedFile.cpp"
+#include "Grammar.cpp"
+using namespace std;
+
+enum GrammarTokenKind {
+    GRAMMAR_NAME,
+    GRAMMAR_ARROW,
+    GRAMMAR_BAR,
+    GRAMMAR_NEWLINE,
+    GRAMMAR_END
+};
+
+// Character classes for the lexer
+enum GrammarCharClass : uint8_t {
+    CHAR_NAME,
+    CHAR_SPACE,
+    CHAR_NEWLINE,
+    CHAR_BAR,
+    CHAR_ARROW_START   // '-' or the first byte of →; part of a name unless an arrow follows
+};
+
+struct GrammarCharClasses {
+    uint8_t of[256] = {};
+
+    constexpr GrammarCharClasses() {
+        for (int c = 0; c < 256; ++c) of[c] = CHAR_NAME;
+        for (unsigned char c : string_view(" \t\r\f\v")) of[c] = CHAR_SPACE;
+        of[(unsigned char)'\n'] = CHAR_NEWLINE;
+        of[(unsigned char)'|'] = CHAR_BAR;
+        of[(unsigned char)'-'] = CHAR_ARROW_START;
+        of[0xE2] = CHAR_ARROW_START;
+    }
+};
+
+constexpr GrammarCharClasses GRAMMAR_CHAR_CLASSES;
+
+// Lexer over a grammar text. Names are maximal runs of anything other than
+// whitespace, '|' and the start of an arrow. It is constexpr so grammars compiled
+// at build time are read by the same rules.
+class GrammarLexer {
+private:
+    string_view input;
+    size_t position = 0;
+
+    constexpr uint8_t classAt(size_t at) const {
+        return GRAMMAR_CHAR_CLASSES.of[(unsigned char)input[at]];
+    }
+
+    // Helper function to get the length of an arrow at a position (0 if none)
+    constexpr size_t arrowAt(size_t at) const {
+        if (input.compare(at, 2, "->") == 0) return 2;
+        if (input.compare(at, 3, "\xE2\x86\x92") == 0) return 3;  // →
+        return 0;
+    }
+
+public:
+    int line = 1;
+
+    constexpr GrammarLexer(string_view text) : input(text) {}
+
+    // Function to get the next token; text points into the input
+    constexpr GrammarTokenKind next(string_view& text) {
+        while (position < input.size() && classAt(position) == CHAR_SPACE) ++position;
+        if (position == input.size()) {
+            text = string_view();
+            return GRAMMAR_END;
+        }
+
+        switch (classAt(position)) {
+        case CHAR_NEWLINE:
+            text = input.substr(position++, 1);
+            ++line;
+            return GRAMMAR_NEWLINE;
+        case CHAR_BAR:
+            text = input.substr(position++, 1);
+            return GRAMMAR_BAR;
+        case CHAR_ARROW_START:
+            if (size_t length = arrowAt(position)) {
+                text = input.substr(position, length);
+                position += length;
+                return GRAMMAR_ARROW;
+            }
+            break;
+        }
+
+        size_t start = position++;
+        while (position < input.size()) {
+            uint8_t type = classAt(position);
+            if (type == CHAR_NAME) {
+                ++position;
+                continue;
+            }
+            if (type != CHAR_ARROW_START || arrowAt(position)) break;
+            ++position;
+        }
+        text = input.substr(start, position - start);
+        return GRAMMAR_NAME;
+    }
+};
+
+// Productions as spans of one token arena: production p is lhs[p] ->
+// rhsTokens[rhsStart[p] .. rhsStart[p + 1]). An ε alternative keeps its ε token;
+// a production without tokens only declares lhs[p] (a rule with no alternatives).
+struct ProductionList {
+    vector<string_view> lhs;
+    vector<uint32_t> rhsStart = {0};
+    vector<string_view> rhsTokens;
+
+    size_t size() const {
+        return lhs.size();
+    }
+
+    const string_view* rhsBegin(size_t production) const {
+        return rhsTokens.data() + rhsStart[production];
+    }
+
+    const string_view* rhsEnd(size_t production) const {
+        return rhsTokens.data() + rhsStart[production + 1];
+    }
+
+    // Function to format the right-hand side as space separated names
+    string rhsText(size_t production) const {
+        string text;
+        for (const string_view* token = rhsBegin(production); token != rhsEnd(production); ++token) {
+            if (!text.empty()) text += " ";
+            text += *token;
+        }
+        return text;
+    }
+};
+
+// A loaded grammar file: the mapping plus the productions that point into it
+struct GrammarSource {
+    MappedFile file;
+    ProductionList productions;
+};
+
+// Helper function to hash a production for duplicate detection
+uint64_t productionHash(const ProductionList& list, size_t production) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&](string_view text) {
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        hash ^= 0xFF;  // separator, so "a b" and "ab" differ
+        hash *= 1099511628211ULL;
+    };
+    mix(list.lhs[production]);
+    for (const string_view* token = list.rhsBegin(production); token != list.rhsEnd(production); ++token) mix(*token);
+    return hash;
+}
+
+bool sameProduction(const ProductionList& list, size_t a, size_t b) {
+    if (list.lhs[a] != list.lhs[b]) return false;
+    if (list.rhsEnd(a) - list.rhsBegin(a) != list.rhsEnd(b) - list.rhsBegin(b)) return false;
+    return equal(list.rhsBegin(a), list.rhsEnd(a), list.rhsBegin(b));
+}
+
+// Function to scan "A -> α | β" lines into a production list. Empty
+// alternatives and repeated productions are dropped, as the old reader did; a
+// line with nothing after the arrow declares a non-terminal without alternatives,
+// which is how writeGrammar prints one. A first pass counts, so every array is
+// allocated exactly once.
+void scanProductions(string_view text, ProductionList& list) {
+    size_t productionCount = 0, tokenCount = 0;
+    {
+        GrammarLexer lexer(text);
+        string_view token;
+        GrammarTokenKind kind;
+        bool arrowSeen = false, alternativeOpen = false;
+        while ((kind = lexer.next(token)) != GRAMMAR_END) {
+            if (kind == GRAMMAR_NEWLINE) {
+                productionCount += arrowSeen;  // last alternative or a declaration
+                arrowSeen = alternativeOpen = false;
+            } else if (kind == GRAMMAR_BAR && arrowSeen) {
+                productionCount += alternativeOpen;
+                alternativeOpen = false;
+            } else if (kind == GRAMMAR_ARROW && !arrowSeen) {
+                arrowSeen = true;
+            } else if (arrowSeen) {
+                tokenCount++;
+                alternativeOpen = true;
+            }
+        }
+        productionCount += arrowSeen;
+    }
+
+    list.lhs.clear();
+    list.rhsStart.assign(1, 0);
+    list.rhsTokens.clear();
+    list.lhs.reserve(productionCount);
+    list.rhsStart.reserve(productionCount + 1);
+    list.rhsTokens.reserve(tokenCount);
+
+    // Open addressing set of production indices for duplicate detection. Each
+    // slot keeps 32 bits of the hash too, so probing rarely touches the arena.
+    struct Slot {
+        uint32_t production = UINT32_MAX;
+        uint32_t tag = 0;
+    };
+    size_t slots = 16;
+    while (slots < productionCount * 2) slots *= 2;
+    vector<Slot> seen(slots);
+
+    auto closeAlternative = [&](string_view lhs, bool declaration) {
+        size_t production = list.lhs.size();
+        if (list.rhsTokens.size() == list.rhsStart.back() && !declaration) return;
+        list.lhs.push_back(lhs);
+        list.rhsStart.push_back(list.rhsTokens.size());
+        uint64_t hash = productionHash(list, production);
+        uint32_t tag = hash >> 32;
+        for (size_t slot = hash & (slots - 1);; slot = (slot + 1) & (slots - 1)) {
+            if (seen[slot].production == UINT32_MAX) {
+                seen[slot] = {(uint32_t)production, tag};
+                return;
+            }
+            if (seen[slot].tag == tag && sameProduction(list, seen[slot].production, production)) break;
+        }
+        // Duplicate: take it back off the arena
+        list.lhs.pop_back();
+        list.rhsStart.pop_back();
+        list.rhsTokens.resize(list.rhsStart.back());
+    };
+
+    GrammarLexer lexer(text);
+    string_view token, lhs;
+    GrammarTokenKind kind;
+    bool arrowSeen = false, lineBad = false, lineEmpty = true;
+    int badLines = 0, firstBadLine = 0;
+    auto markBad = [&](int line) {
+        if (lineBad) return;
+        lineBad = true;
+        if (badLines++ == 0) firstBadLine = line;
+    };
+    while ((kind = lexer.next(token)) != GRAMMAR_END) {
+        if (kind == GRAMMAR_NEWLINE) {
+            if (arrowSeen) closeAlternative(lhs, lineEmpty);
+            else if (!lhs.empty()) markBad(lexer.line - 1);
+            lhs = string_view();
+            arrowSeen = lineBad = false;
+            lineEmpty = true;
+        } else if (lineBad) {
+            continue;
+        } else if (!arrowSeen) {
+            if (kind == GRAMMAR_ARROW && !lhs.empty()) arrowSeen = true;
+            else if (kind == GRAMMAR_NAME && lhs.empty()) lhs = token;
+            else markBad(lexer.line);
+        } else if (kind == GRAMMAR_BAR) {
+            closeAlternative(lhs, false);
+        } else {
+            list.rhsTokens.push_back(token);
+            lineEmpty = false;
+        }
+    }
+    if (arrowSeen) closeAlternative(lhs, lineEmpty);
+    else if (!lhs.empty()) markBad(lexer.line);
+    if (badLines) {
+        cerr << "Warning: skipped " << badLines << " malformed grammar line(s), first at line " << firstBadLine
+             << " (expected \"A -> α | β\")" << endl;
+    }
+}
+
+// Function to map and scan a grammar file
+bool readGrammarFile(const string& filename, GrammarSource& source) {
+    if (!source.file.open(filename)) {
+        cerr << "Error: Unable to open file " << filename << endl;
+        source.productions = ProductionList();
+        return false;
+    }
+    scanProductions(source.file.text(), source.productions);
+    return true;
+}
+
+// Function to build a grammar from a production list
+Grammar grammarFromProductionList(const ProductionList& list) {
+    Grammar grammar;
+    grammar.symbols.reserve(list.rhsTokens.size() / 2 + list.size());
+    vector<int> lhs;
+    AlternativeList alternatives;
+    lhs.reserve(list.size());
+    alternatives.symbols.reserve(list.rhsTokens.size());
+    alternatives.starts.reserve(list.size() + 1);
+    vector<int> declared;  // every left side in first-seen order, with or without alternatives
+    vector<char> seen;
+    for (size_t p = 0; p < list.size(); ++p) {
+        int symbol = grammar.symbols.intern(list.lhs[p]);
+        if (grammar.startSymbol < 0) grammar.startSymbol = symbol;
+        if (symbol >= (int)seen.size()) seen.resize(symbol + 1, 0);
+        if (!seen[symbol]) declared.push_back(symbol);
+        seen[symbol] = 1;
+        if (list.rhsBegin(p) == list.rhsEnd(p)) continue;
+        lhs.push_back(symbol);
+        for (const string_view* token = list.rhsBegin(p); token != list.rhsEnd(p); ++token) {
+            int id = grammar.symbols.intern(*token);
+            if (id != EPSILON_ID) alternatives.push(id);
+        }
+        alternatives.close();
+    }
+    grammar.addAlternatives(lhs, alternatives);
+    grammar.nonTerminals.swap(declared);
+    return grammar;
+}
@@ -0,0 +1,278 @@
+// Incremental recomputation of FIRST/FOLLOW sets and parse-table rows after
+// the alternatives of one non-terminal are edited
+
+#pragma once
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+#include "Pipeline.cpp"
+using namespace std;
+
+struct EditReport {
+    bool fullRebuild = false;   // the edit needed symbols the analysis had never seen
+    int firstRecomputed = 0;    // FIRST sets recomputed
+    int followRecomputed = 0;   // FOLLOW sets recomputed
+    int rowsRebuilt = 0;        // parse-table rows refilled
+    double milliseconds = 0;
+};
+
+class IncrementalGrammar {
+private:
+    GrammarPipeline& pipeline;
+    vector<vector<SymbolOccurrence>> occurrences;  // non-terminal id -> every place it appears
+    vector<vector<int>> productionsOf;             // non-terminal id -> its table production ids
+    vector<vector<string>> rowConflicts;           // table row -> LL(1) conflicts in that row
+    size_t deadProductions = 0;                    // table productions no rule uses any more
+
+    // Helper function to add or remove the occurrences contributed by one non-terminal's rules
+    void indexRules(int lhs, bool add) {
+        Grammar::RuleView alternatives = pipeline.grammar.rule(lhs);
+        for (int alternative = 0; alternative < (int)alternatives.size(); ++alternative) {
+            SymbolSpan rule = alternatives[alternative];
+            for (int position = 0; position < (int)rule.size(); ++position) {
+                int symbol = rule[position];
+                if (!pipeline.sets->isNonTerminal(symbol)) continue;
+                auto& list = occurrences[symbol];
+                if (add) {
+                    list.push_back({lhs, alternative, position});
+                } else {
+                    list.erase(remove_if(list.begin(), list.end(),
+                                         [&](const SymbolOccurrence& at) { return at.lhs == lhs; }),
+                               list.end());
+                }
+            }
+        }
+    }
+
+    // Helper function to index the whole grammar and table from scratch
+    void rebuildIndexes() {
+        int symbolCount = pipeline.grammar.symbols.size();
+        occurrences.assign(symbolCount, vector<SymbolOccurrence>());
+        for (int nonTerminal : pipeline.grammar.nonTerminals) indexRules(nonTerminal, true);
+
+        const ParseTable& table = pipeline.table;
+        productionsOf.assign(symbolCount, vector<int>());
+        for (int production = 0; production < (int)table.productionLhs.size(); ++production) {
+            productionsOf[table.productionLhs[production]].push_back(production);
+        }
+        deadProductions = 0;
+        rowConflicts.assign(table.rows, vector<string>());
+        for (int nonTerminal : pipeline.grammar.nonTerminals) {
+            fillParseTableRow(pipeline.table, *pipeline.sets, nonTerminal, productionsOf[nonTerminal],
+                              rowConflicts[table.nonTerminalRow[nonTerminal]]);
+        }
+    }
+
+    // Helper function to drop the table productions no rule uses any more. The rest
+    // are renumbered in row order and the cells are remapped; cells still holding a
+    // dropped production (the row being edited) are cleared.
+    void compactProductions() {
+        ParseTable& table = pipeline.table;
+        vector<uint16_t> renumber(table.productionLhs.size(), NO_PRODUCTION);
+        vector<int> lhs, rhsStart = {0}, rhsSymbols;
+        lhs.reserve(table.productionLhs.size() - deadProductions);
+        rhsStart.reserve(lhs.capacity() + 1);
+        for (int nonTerminal : table.rowSymbol) {
+            for (int& production : productionsOf[nonTerminal]) {
+                renumber[production] = lhs.size();
+                lhs.push_back(nonTerminal);
+                rhsSymbols.insert(rhsSymbols.end(), table.rhsSymbols.begin() + table.rhsStart[production],
+                                  table.rhsSymbols.begin() + table.rhsStart[production + 1]);
+                rhsStart.push_back(rhsSymbols.size());
+                production = renumber[production];
+            }
+        }
+        table.productionLhs.swap(lhs);
+        table.rhsStart.swap(rhsStart);
+        table.rhsSymbols.swap(rhsSymbols);
+        for (uint16_t& cell : table.cells) {
+            if (cell != NO_PRODUCTION) cell = renumber[cell];
+        }
+        deadProductions = 0;
+    }
+
+    // Helper function to add a symbol to a worklist once
+    static void mark(int symbol, vector<char>& seen, vector<int>& list) {
+        if (seen[symbol]) return;
+        seen[symbol] = 1;
+        list.push_back(symbol);
+    }
+
+    bool allNonTerminals(SymbolSpan rule, size_t from, size_t to) const {
+        for (size_t i = from; i < to; ++i) {
+            if (!pipeline.sets->isNonTerminal(rule[i])) return false;
+        }
+        return true;
+    }
+
+public:
+    // Constructor: the pipeline must already have run
+    IncrementalGrammar(GrammarPipeline& p) : pipeline(p) {
+        if (pipeline.table.compressed) buildParseTable(*pipeline.sets, pipeline.table);
+        rebuildIndexes();
+    }
+
+    // Function to replace the alternatives of a non-terminal given as "A -> x y | z | ε"
+    bool edit(const string& rule, EditReport& report) {
+        size_t arrow = rule.find("->");
+        if (arrow == string::npos) {
+            cerr << "Error: edit must look like \"A -> x y | z\": " << rule << endl;
+            return false;
+        }
+        stringstream lhsStream(rule.substr(0, arrow));
+        string lhsName;
+        lhsStream >> lhsName;
+
+        Grammar& grammar = pipeline.grammar;
+        AlternativeList alternatives;
+        stringstream rhsStream(rule.substr(arrow + 2));
+        string alternative;
+        while (getline(rhsStream, alternative, '|')) {
+            stringstream ss(alternative);
+            string token;
+            while (ss >> token) {
+                int id = grammar.symbols.intern(token);
+                if (id != EPSILON_ID) alternatives.push(id);
+            }
+            alternatives.close();
+        }
+        if (lhsName.empty() || alternatives.empty()) return false;
+        return replaceAlternatives(grammar.symbols.intern(lhsName), alternatives, report);
+    }
+
+    // Function to replace the alternatives of a non-terminal and update only what depends on it
+    bool replaceAlternatives(int lhs, const AlternativeList& alternatives, EditReport& report) {
+        auto start = chrono::steady_clock::now();
+        report = EditReport();
+        Grammar& grammar = pipeline.grammar;
+        grammar.grow();
+        int symbolCount = grammar.symbols.size();
+        vector<char> inFirst(symbolCount, 0), inFollow(symbolCount, 0), inRows(symbolCount, 0);
+        vector<int> firstAffected, followAffected, rows;
+
+        // Symbols of the old and new rules can gain or lose FOLLOW contributions
+        for (SymbolSpan rule : grammar.rule(lhs)) {
+            for (int symbol : rule) {
+                if (pipeline.sets->isNonTerminal(symbol)) mark(symbol, inFollow, followAffected);
+            }
+        }
+        indexRules(lhs, false);
+
+        // The sets edit the grammar they share with the pipeline. New symbols need
+        // fresh terminal bits and table columns: rebuild everything
+        if (!pipeline.sets->isNonTerminal(lhs) || !pipeline.sets->replaceAlternatives(lhs, alternatives)) {
+            // A rule left without alternatives is still listed
+            if (find(grammar.nonTerminals.begin(), grammar.nonTerminals.end(), lhs) == grammar.nonTerminals.end()) {
+                grammar.nonTerminals.push_back(lhs);
+            }
+            grammar.setRule(lhs, alternatives);
+            pipeline.computeSets();
+            if (!buildParseTable(*pipeline.sets, pipeline.table)) return false;
+            rebuildIndexes();
+            report.fullRebuild = true;
+            report.firstRecomputed = report.followRecomputed = report.rowsRebuilt = grammar.nonTerminals.size();
+            report.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            return true;
+        }
+
+        indexRules(lhs, true);
+        for (int symbol : alternatives.symbols) {
+            if (pipeline.sets->isNonTerminal(symbol)) mark(symbol, inFollow, followAffected);
+        }
+
+        // FIRST: everything that reaches lhs through a leading run of non-terminals
+        mark(lhs, inFirst, firstAffected);
+        for (size_t i = 0; i < firstAffected.size(); ++i) {
+            for (const SymbolOccurrence& at : occurrences[firstAffected[i]]) {
+                SymbolSpan rule = grammar.alternative(at.lhs, at.alternative);
+                if (allNonTerminals(rule, 0, at.position)) mark(at.lhs, inFirst, firstAffected);
+            }
+        }
+        pipeline.sets->recomputeFirst(firstAffected, occurrences);
+
+        // FOLLOW: anything sitting before a symbol whose FIRST was recomputed, then
+        // closed under the FOLLOW(A) ⊆ FOLLOW(B) edges of the updated grammar
+        for (int changed : firstAffected) {
+            for (const SymbolOccurrence& at : occurrences[changed]) {
+                SymbolSpan rule = grammar.alternative(at.lhs, at.alternative);
+                for (int i = 0; i < at.position; ++i) {
+                    if (pipeline.sets->isNonTerminal(rule[i])) mark(rule[i], inFollow, followAffected);
+                }
+            }
+        }
+        for (size_t n = 0; n < followAffected.size(); ++n) {
+            int A = followAffected[n];
+            Grammar::RuleView alternatives = grammar.rule(A);
+            for (size_t k = 0; k < alternatives.size(); ++k) {
+                SymbolSpan rule = alternatives[k];
+                for (size_t i = 0; i < rule.size(); ++i) {
+                    if (pipeline.sets->isNonTerminal(rule[i]) && pipeline.sets->inheritsFollow(A, k, i)) {
+                        mark(rule[i], inFollow, followAffected);
+                    }
+                }
+            }
+        }
+        pipeline.sets->recomputeFollow(followAffected, occurrences);
+
+        // Table rows: the edited row plus every row whose FIRST or FOLLOW may have moved
+        // The replaced productions are dead; they are dropped once they make up half
+        // the table, or sooner if the new ones would not fit in 16-bit ids
+        ParseTable& table = pipeline.table;
+        deadProductions += productionsOf[lhs].size();
+        productionsOf[lhs].clear();
+        if (deadProductions > table.productionLhs.size() / 2 + 1024 ||
+            table.productionLhs.size() + alternatives.size() >= NO_PRODUCTION) {
+            compactProductions();
+        }
+        for (size_t i = 0; i < alternatives.size(); ++i) {
+            int index = addTableProduction(table, lhs, alternatives[i]);
+            if (index < 0) return false;
+            productionsOf[lhs].push_back(index);
+        }
+        mark(lhs, inRows, rows);
+        for (int symbol : firstAffected) mark(symbol, inRows, rows);
+        for (int symbol : followAffected) mark(symbol, inRows, rows);
+        for (int nonTerminal : rows) {
+            vector<string>& conflicts = rowConflicts[table.nonTerminalRow[nonTerminal]];
+            conflicts.clear();
+            fillParseTableRow(table, *pipeline.sets, nonTerminal, productionsOf[nonTerminal], conflicts);
+        }
+        table.conflicts.clear();
+        for (const auto& conflicts : rowConflicts) {
+            table.conflicts.insert(table.conflicts.end(), conflicts.begin(), conflicts.end());
+        }
+
+        report.firstRecomputed = firstAffected.size();
+        report.followRecomputed = followAffected.size();
+        report.rowsRebuilt = rows.size();
+        report.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+    // Function to check the incremental state against a from-scratch computation.
+    // The reference works on a copy, so checking never touches the live grammar.
+    bool matchesFullRebuild() {
+        Grammar copy = pipeline.grammar;
+        FirstFollowSet fresh(copy);
+        fresh.computeAllFirst();
+        fresh.computeAllFollow();
+        pipeline.sets->exportNamedSets();
+        if (fresh.first != pipeline.sets->first || fresh.follow != pipeline.sets->follow) return false;
+
+        ParseTable freshTable;
+        if (!buildParseTable(fresh, freshTable)) return false;
+        const ParseTable& table = pipeline.table;
+        if (freshTable.rows != table.rows || freshTable.columns != table.columns) return false;
+        for (int row = 0; row < table.rows; ++row) {
+            for (int column = 0; column < table.columns; ++column) {
+                uint16_t a = freshTable.lookup(row, column), b = table.lookup(row, column);
+                if ((a == NO_PRODUCTION) != (b == NO_PRODUCTION)) return false;
+                if (a != NO_PRODUCTION && freshTable.productionText(a) != table.productionText(b)) return false;
+            }
+        }
+        return true;
+    }
+};
@@ -0,0 +1,101 @@
+// Read-only view of a whole file: memory mapped where the platform allows,
+// otherwise read into an 8-byte aligned buffer
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+using namespace std;
+
+class MappedFile {
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    vector<uint64_t> buffer;    // aligned copy when the file could not be mapped
+    string errorText;
+
+public:
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // Function to map (or read) a file; an empty file opens as an empty view
+    bool open(const string& filename) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            errorText = "cannot open " + filename;
+            return false;
+        }
+        struct stat info;
+        bool sized = fstat(fd, &info) == 0;
+        if (sized && info.st_size == 0) {
+            // mmap cannot map an empty file
+            ::close(fd);
+            return true;
+        }
+        if (sized) {
+            void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                base = (const char*)address;
+                length = info.st_size;
+                mapped = true;
+            }
+        }
+        ::close(fd);
+        if (mapped) return true;
+#endif
+        ifstream in(filename, ios::binary | ios::ate);
+        if (!in) {
+            errorText = "cannot open " + filename;
+            return false;
+        }
+        length = in.tellg();
+        buffer.resize((length + 7) / 8);
+        in.seekg(0);
+        if (!in.read((char*)buffer.data(), length)) {
+            errorText = "cannot read " + filename;
+            length = 0;
+            return false;
+        }
+        base = (const char*)buffer.data();
+        return true;
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (mapped) munmap((void*)base, length);
+#endif
+        base = nullptr;
+        length = 0;
+        mapped = false;
+        buffer.clear();
+    }
+
+    const char* data() const {
+        return base;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    string_view text() const {
+        return string_view(base, length);
+    }
+
+    const string& error() const {
+        return errorText;
+    }
+};
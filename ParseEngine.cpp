@@ -0,0 +1,314 @@
+// Table-driven LL(1) predictive parser that runs over token streams
+
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+#include <string_view>
+#include <cctype>
+#include "ParseTable.cpp"
+#include "ParseTree.cpp"
+#include "DfaLexer.cpp"
+using namespace std;
+
+// One syntax error: the token at position could not be taken by the symbol on
+// top of the stack. Recovery reports one error per run of skipped tokens.
+struct ParseError {
+    uint32_t position;   // index of the offending token
+    int found;           // its terminal id (-1 for an unknown token)
+    int expected;        // stack symbol that could not take it
+};
+
+// Push-driven LL(1) stack machine. The stack is allocated once up front, so
+// feeding tokens does not touch the heap unless a parse nests deeper than the
+// preallocated capacity. With a tree attached, every stack entry also carries
+// the tree node it will become, and the tree's arrays are reused across parses.
+// With error recovery on, a token the table has no entry for starts panic mode
+// instead of ending the parse, so one pass finds every error; finish() accepts
+// only inputs that needed no recovery, and errors() lists the rest.
+class LL1ParseEngine {
+private:
+    ParseTableView table;
+    vector<int> stack;
+    vector<int> nodes;  // tree node of each stack entry (only while building a tree)
+    size_t top = 0;
+    uint32_t position = 0;  // tokens consumed so far
+    bool failed = false;
+    ParseTree* tree = nullptr;
+    bool recover = false;
+    bool recovering = false;     // inside a run of errors; nothing is reported until a token matches
+    vector<ParseError> errorLog;
+
+    void push(int symbol) {
+        if (top == stack.size()) {
+            stack.resize(stack.size() * 2);
+            if (tree) nodes.resize(stack.size());
+        }
+        stack[top++] = symbol;
+    }
+
+    // Helper function for panic-mode recovery once the stack top cannot take a token.
+    // Symbols are popped while they cannot take it: terminals always (as if they had
+    // been there), non-terminals only if the token is in their synchronization set.
+    // Returns true once the new stack top can take the token, false if the token is
+    // skipped instead. Each skipped token costs one table lookup and one bit test.
+    bool synchronize(int terminal, int column) {
+        if (!recovering) errorLog.push_back({position, terminal, stack[top - 1]});
+        recovering = true;
+        while (column >= 0) {
+            int symbol = stack[top - 1];
+            int row = table.nonTerminalRow[symbol];
+            if (row >= 0) {
+                if (table.lookup(row, column) != NO_PRODUCTION) return true;
+                if (!table.synchronizes(row, column)) break;
+            } else if (symbol == terminal) {
+                return true;
+            } else if (symbol == END_MARKER_ID) {
+                break;
+            }
+            --top;
+        }
+        ++position;
+        return false;
+    }
+
+public:
+    // Constructor: runs on an in-memory table or a mapped table image alike
+    LL1ParseEngine(const ParseTableView& parseTable, size_t stackCapacity = 1024)
+        : table(parseTable), stack(stackCapacity < 2 ? 2 : stackCapacity) {
+        reset();
+    }
+
+    LL1ParseEngine(const ParseTable& parseTable, size_t stackCapacity = 1024)
+        : LL1ParseEngine(parseTable.view(), stackCapacity) {}
+
+    // Function to build a parse tree into the given tree on every parse (nullptr stops)
+    void buildTree(ParseTree* target) {
+        tree = target;
+        if (tree) nodes.resize(stack.size());
+        reset();
+    }
+
+    // Function to turn panic-mode error recovery on or off
+    void recoverErrors(bool enabled) {
+        recover = enabled;
+        reset();
+    }
+
+    // Function to start a new parse
+    void reset() {
+        top = 0;
+        position = 0;
+        failed = false;
+        recovering = false;
+        errorLog.clear();
+        push(END_MARKER_ID);
+        push(table.startSymbol);
+        if (tree) {
+            tree->clear();
+            nodes[0] = -1;
+            nodes[1] = tree->addNode(table.startSymbol, -1, -1);
+        }
+    }
+
+    // Function to consume one terminal; returns false once the input is rejected
+    bool feed(int terminal) {
+        if (failed) return false;
+        int column = terminal < 0 ? -1 : table.terminalColumn[terminal];
+        if (column < 0) {
+            if (!recover || top == 0) return failed = true, false;
+            synchronize(terminal, column);
+            return true;
+        }
+        while (top > 0) {
+            int symbol = stack[top - 1];
+            int row = table.nonTerminalRow[symbol];
+            if (row < 0) {
+                if (symbol == terminal) {
+                    --top;
+                    if (tree && nodes[top] >= 0) tree->match(nodes[top], position);
+                    ++position;
+                    recovering = false;
+                    return true;
+                }
+            } else {
+                uint16_t production = table.lookup(row, column);
+                if (production != NO_PRODUCTION) {
+                    --top;
+                    const int* rhs = table.rhsSymbols;
+                    int begin = table.rhsStart[production], end = table.rhsStart[production + 1];
+                    if (tree) {
+                        // Children take consecutive nodes in rhs order, pushed last to first
+                        int first = tree->expand(nodes[top], production, rhs + begin, end - begin, position);
+                        for (int i = end - 1; i >= begin; --i) {
+                            push(rhs[i]);
+                            nodes[top - 1] = first + (i - begin);
+                        }
+                        continue;
+                    }
+                    for (int i = end - 1; i >= begin; --i) push(rhs[i]);
+                    continue;
+                }
+            }
+            if (!recover) return failed = true, false;
+            if (!synchronize(terminal, column)) return true;
+        }
+        return failed = true, false;
+    }
+
+    // Function to signal end of input; returns true if the input is accepted
+    bool finish() {
+        bool accepted = feed(END_MARKER_ID) && top == 0 && errorLog.empty();
+        if (accepted && tree) tree->finishSpans();
+        return accepted;
+    }
+
+    // Function to get the errors recovered from in the current parse
+    const vector<ParseError>& errors() const {
+        return errorLog;
+    }
+
+    // Function to parse a complete token sequence
+    bool parse(const vector<int>& tokens) {
+        reset();
+        for (int token : tokens) {
+            if (!feed(token)) return false;
+        }
+        return finish();
+    }
+};
+
+// Function to append the terminal ids of whitespace separated text from position i
+// until the text ends or tokens holds limit entries; returns the position to resume from
+size_t tokenizeText(const ParseTableView& table, string_view text, size_t i, vector<int>& tokens, size_t limit) {
+    while (i < text.size() && tokens.size() < limit) {
+        while (i < text.size() && isspace((unsigned char)text[i])) ++i;
+        size_t start = i;
+        while (i < text.size() && !isspace((unsigned char)text[i])) ++i;
+        if (i > start) tokens.push_back(table.terminalId(text.substr(start, i - start)));
+    }
+    return i;
+}
+
+// Function to split whitespace separated text into terminal ids without copying tokens
+void tokenizeText(const ParseTableView& table, string_view text, vector<int>& tokens) {
+    tokens.clear();
+    tokenizeText(table, text, 0, tokens, SIZE_MAX);
+}
+
+// Function to split a whitespace separated line into terminal ids
+void tokenizeLine(const ParseTableView& table, const string& line, vector<int>& tokens) {
+    tokenizeText(table, line, tokens);
+}
+
+struct ParseStats {
+    size_t inputs = 0;
+    size_t accepted = 0;
+    size_t tokens = 0;
+    double seconds = 0;
+    double tokenizeSeconds = 0;
+    size_t errors = 0;        // errors recovered from, with recovery on
+    size_t treeNodes = 0;     // nodes built when parse trees were requested
+    double treeSeconds = 0;
+    size_t fullRingWaits = 0;   // pipelined mode: times the tokenizer waited for the parser
+    size_t emptyRingWaits = 0;  // pipelined mode: times the parser waited for the tokenizer
+
+    double tokensPerSecond() const {
+        return seconds > 0 ? tokens / seconds : 0;
+    }
+};
+
+struct ParseInputOptions {
+    bool verbose = true;              // print ACCEPT / REJECT for every line
+    bool printTrees = false;          // parse accepted lines again into a tree and print it
+    bool recover = false;             // parse every line to the end and list all its errors
+    const DfaLexer* lexer = nullptr;  // generated lexer; without one, tokens are split at whitespace
+};
+
+// Function to parse every non-empty line of a file and report throughput
+ParseStats parseInputFile(const ParseTableView& table, const string& filename, const ParseInputOptions& options) {
+    bool verbose = options.verbose, printTrees = options.printTrees, recover = options.recover;
+    ParseStats stats;
+    ifstream file(filename);
+    if (!file) {
+        cerr << "Error: Unable to open file " << filename << endl;
+        return stats;
+    }
+
+    vector<string> lines;
+    string line;
+    while (getline(file, line)) {
+        if (line.find_first_not_of(" \t\r") != string::npos) lines.push_back(line);
+    }
+    file.close();
+
+    // Tokenize up front, timed on its own, so the parse timing covers only the engine
+    vector<vector<int>> inputs(lines.size());
+    auto tokenizeStart = chrono::steady_clock::now();
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (options.lexer) options.lexer->tokenize(lines[i], inputs[i]);
+        else tokenizeLine(table, lines[i], inputs[i]);
+        stats.tokens += inputs[i].size();
+    }
+    stats.tokenizeSeconds = chrono::duration<double>(chrono::steady_clock::now() - tokenizeStart).count();
+
+    LL1ParseEngine engine(table);
+    engine.recoverErrors(recover);
+    vector<char> results(inputs.size());
+    vector<ParseError> errors;
+    vector<size_t> errorStart(inputs.size() + 1, 0);  // input i has errors[errorStart[i] .. errorStart[i + 1])
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        results[i] = engine.parse(inputs[i]);
+        if (recover) {
+            errors.insert(errors.end(), engine.errors().begin(), engine.errors().end());
+            errorStart[i + 1] = errors.size();
+        }
+    }
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.inputs = inputs.size();
+    stats.errors = errors.size();
+
+    // Trees are built in a separate timed pass that reuses one tree's storage
+    ParseTree tree;
+    LL1ParseEngine treeEngine(table);
+    if (printTrees) treeEngine.buildTree(&tree);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (results[i]) stats.accepted++;
+        if (verbose) cout << (results[i] ? "ACCEPT  " : "REJECT  ") << lines[i] << endl;
+        for (size_t e = errorStart[i]; verbose && recover && e < errorStart[i + 1]; ++e) {
+            const ParseError& error = errors[e];
+            cout << "        error at token " << error.position << ": "
+                 << (error.found < 0 ? string("unknown token") : "unexpected " + string(table.name(error.found)))
+                 << " where " << table.name(error.expected) << " was expected" << endl;
+        }
+        if (!printTrees || !results[i]) continue;
+        auto treeStart = chrono::steady_clock::now();
+        treeEngine.parse(inputs[i]);
+        stats.treeSeconds += chrono::duration<double>(chrono::steady_clock::now() - treeStart).count();
+        stats.treeNodes += tree.size();
+        writeParseTree(tree, table, cout);
+    }
+    return stats;
+}
+
+// Function to print throughput of a parse run
+void printParseStats(const ParseStats& stats) {
+    cout << "\nParsed " << stats.inputs << " inputs (" << stats.accepted << " accepted, "
+         << stats.inputs - stats.accepted << " rejected), " << stats.tokens << " tokens in "
+         << stats.seconds * 1000 << " ms = " << (size_t)stats.tokensPerSecond() << " tokens/s" << endl;
+    if (stats.tokenizeSeconds > 0) cout << "Tokenized in " << stats.tokenizeSeconds * 1000 << " ms" << endl;
+    if (stats.errors) cout << "Recovered from " << stats.errors << " syntax errors" << endl;
+    if (stats.fullRingWaits || stats.emptyRingWaits) {
+        cout << "Tokenizer waited on a full ring " << stats.fullRingWaits << " times, parser on an empty ring "
+             << stats.emptyRingWaits << " times" << endl;
+    }
+    if (stats.treeNodes) {
+        cout << "Built parse trees for " << stats.accepted << " inputs (" << stats.treeNodes << " nodes) in "
+             << stats.treeSeconds * 1000 << " ms" << endl;
+    }
+}
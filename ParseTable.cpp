@@ -0,0 +1,363 @@
+// Dense LL(1) parsing table: [non-terminal × terminal] -> production index
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <string_view>
+#include "FirstFollow.cpp"
+using namespace std;
+
+const uint16_t NO_PRODUCTION = 0xFFFF;
+
+// Read-only view of a parse table: flat arrays the parse engine reads directly.
+// It points either into a ParseTable (valid until that table changes) or into a
+// mapped table image, so the engine never cares where the table came from.
+struct ParseTableView {
+    int symbolCount = 0;
+    int startSymbol = -1;
+    int rows = 0;
+    int columns = 0;
+    int productionCount = 0;
+    const int* nonTerminalRow = nullptr;
+    const int* terminalColumn = nullptr;
+    const int* rowSymbol = nullptr;
+    const int* columnSymbol = nullptr;
+    const int* productionLhs = nullptr;
+    const int* rhsStart = nullptr;
+    const int* rhsSymbols = nullptr;
+    const uint16_t* cells = nullptr;
+
+    bool compressed = false;
+    const int* rowOffset = nullptr;
+    const uint16_t* combValue = nullptr;
+    const uint16_t* combOwner = nullptr;
+
+    // Panic-mode synchronization sets: one bitset over the columns per row
+    int syncWords = 0;
+    const uint64_t* syncSets = nullptr;
+
+    // Symbol names: an in-memory table has a SymbolTable, an image has a name
+    // blob plus the symbol ids sorted by name for binary search
+    const SymbolTable* symbols = nullptr;
+    const uint32_t* nameOffsets = nullptr;   // symbol id -> start in names (symbolCount + 1 entries)
+    const char* names = nullptr;
+    const int* nameOrder = nullptr;
+
+    uint16_t lookup(int row, int column) const {
+        if (!compressed) return cells[(size_t)row * columns + column];
+        size_t slot = rowOffset[row] + column;
+        return combOwner[slot] == row ? combValue[slot] : NO_PRODUCTION;
+    }
+
+    // Function to test whether a non-terminal may be abandoned when the column's
+    // terminal arrives during error recovery (without sets only $ qualifies)
+    bool synchronizes(int row, int column) const {
+        if (!syncSets) return columnSymbol[column] == END_MARKER_ID;
+        return (syncSets[(size_t)row * syncWords + (column >> 6)] >> (column & 63)) & 1;
+    }
+
+    string_view name(int id) const {
+        if (symbols) return symbols->name(id);
+        return string_view(names + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+    }
+
+    // Function to map a symbol name to its id (-1 if unknown)
+    int find(string_view text) const {
+        if (symbols) return symbols->find(text);
+        int low = 0, high = symbolCount;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (name(nameOrder[middle]) < text) low = middle + 1;
+            else high = middle;
+        }
+        return low < symbolCount && name(nameOrder[low]) == text ? nameOrder[low] : -1;
+    }
+
+    // Function to map a token name to its terminal symbol id (-1 if unknown)
+    int terminalId(string_view text) const {
+        int id = find(text);
+        if (id < 0 || id == EPSILON_ID || terminalColumn[id] < 0) return -1;
+        return id;
+    }
+};
+
+struct ParseTable {
+    SymbolTable symbols;
+    int startSymbol = -1;
+    int rows = 0;                    // one row per non-terminal
+    int columns = 0;                 // one column per terminal bit (column 0 is ε and stays empty)
+    vector<int> nonTerminalRow;      // symbol id -> row (or -1 for terminals)
+    vector<int> terminalColumn;      // symbol id -> column (or -1 for non-terminals)
+    vector<int> rowSymbol;           // row -> symbol id
+    vector<int> columnSymbol;        // column -> symbol id
+
+    // Productions with their right-hand sides stored back to back as symbol ids
+    vector<int> productionLhs;
+    vector<int> rhsStart;            // production p occupies rhsSymbols[rhsStart[p] .. rhsStart[p + 1])
+    vector<int> rhsSymbols;
+
+    vector<uint16_t> cells;          // row * columns + column, NO_PRODUCTION if empty
+
+    // Row displacement (comb vector) form of cells, used when compressed is set
+    bool compressed = false;
+    vector<int> rowOffset;           // row -> start of its slice in combValue
+    vector<uint16_t> combValue;
+    vector<uint16_t> combOwner;      // row that owns each slot (NO_PRODUCTION if free)
+
+    // Synchronization set of every row: FOLLOW of its non-terminal plus $, as
+    // syncWords words per row with one bit per column
+    int syncWords = 0;
+    vector<uint64_t> syncSets;
+
+    vector<string> conflicts;
+
+    // Function to look up the production for a row and column in O(1)
+    uint16_t lookup(int row, int column) const {
+        if (!compressed) return cells[(size_t)row * columns + column];
+        size_t slot = rowOffset[row] + column;
+        return combOwner[slot] == row ? combValue[slot] : NO_PRODUCTION;
+    }
+
+    // Function to map a token name to its terminal symbol id (-1 if unknown)
+    int terminalId(const string& name) const {
+        int id = symbols.find(name);
+        if (id < 0 || id == EPSILON_ID || terminalColumn[id] < 0) return -1;
+        return id;
+    }
+
+    int rhsLength(int production) const {
+        return rhsStart[production + 1] - rhsStart[production];
+    }
+
+    // Function to get a view the parse engine can run on
+    ParseTableView view() const {
+        ParseTableView v;
+        v.symbolCount = symbols.size();
+        v.startSymbol = startSymbol;
+        v.rows = rows;
+        v.columns = columns;
+        v.productionCount = productionLhs.size();
+        v.nonTerminalRow = nonTerminalRow.data();
+        v.terminalColumn = terminalColumn.data();
+        v.rowSymbol = rowSymbol.data();
+        v.columnSymbol = columnSymbol.data();
+        v.productionLhs = productionLhs.data();
+        v.rhsStart = rhsStart.data();
+        v.rhsSymbols = rhsSymbols.data();
+        v.cells = cells.data();
+        v.compressed = compressed;
+        v.rowOffset = rowOffset.data();
+        v.combValue = combValue.data();
+        v.combOwner = combOwner.data();
+        v.syncWords = syncWords;
+        v.syncSets = syncSets.data();
+        v.symbols = &symbols;
+        return v;
+    }
+
+    // Function to format a production as "A -> x y z"
+    string productionText(int production) const {
+        string text = symbols.name(productionLhs[production]) + " ->";
+        if (rhsLength(production) == 0) return text + " ε";
+        for (int i = rhsStart[production]; i < rhsStart[production + 1]; ++i) {
+            text += " " + symbols.name(rhsSymbols[i]);
+        }
+        return text;
+    }
+};
+
+// Function to pack the dense cells into a comb vector by first-fit row displacement.
+// Dense rows are placed first; a slot belongs to a row only if combOwner says so.
+void compressParseTable(ParseTable& table) {
+    // Owners are 16-bit row ids and NO_PRODUCTION marks a free slot, so a table with
+    // that many rows could not tell its last row from a gap; it stays dense
+    if (table.rows >= NO_PRODUCTION) {
+        cerr << "Warning: " << table.rows << " rows are too many to compress; the table stays dense" << endl;
+        return;
+    }
+    vector<int> order(table.rows);
+    vector<int> filled(table.rows, 0);
+    for (int row = 0; row < table.rows; ++row) {
+        order[row] = row;
+        for (int column = 0; column < table.columns; ++column) {
+            if (table.cells[(size_t)row * table.columns + column] != NO_PRODUCTION) filled[row]++;
+        }
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return filled[a] > filled[b]; });
+
+    table.rowOffset.assign(table.rows, 0);
+    table.combValue.assign(table.columns, NO_PRODUCTION);
+    table.combOwner.assign(table.columns, NO_PRODUCTION);
+    vector<int> used;
+    for (int row : order) {
+        used.clear();
+        for (int column = 0; column < table.columns; ++column) {
+            if (table.cells[(size_t)row * table.columns + column] != NO_PRODUCTION) used.push_back(column);
+        }
+
+        int offset = 0;
+        for (;; ++offset) {
+            bool fits = true;
+            for (int column : used) {
+                size_t slot = offset + column;
+                if (slot < table.combOwner.size() && table.combOwner[slot] != NO_PRODUCTION) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) break;
+        }
+
+        // Keep every offset + column in range so lookup never needs a bounds check
+        size_t needed = (size_t)offset + table.columns;
+        if (table.combOwner.size() < needed) {
+            table.combValue.resize(needed, NO_PRODUCTION);
+            table.combOwner.resize(needed, NO_PRODUCTION);
+        }
+        table.rowOffset[row] = offset;
+        for (int column : used) {
+            table.combValue[offset + column] = table.cells[(size_t)row * table.columns + column];
+            table.combOwner[offset + column] = row;
+        }
+    }
+
+    table.compressed = true;
+    table.cells.clear();
+    table.cells.shrink_to_fit();
+}
+
+// Function to append a production to the table's right-hand side arrays (-1 if the 16-bit index space is full)
+int addTableProduction(ParseTable& table, int lhs, SymbolSpan rhs) {
+    if (table.productionLhs.size() >= NO_PRODUCTION) {
+        cerr << "Error: grammar has more productions than a 16-bit table entry can hold" << endl;
+        return -1;
+    }
+    if (table.rhsStart.empty()) table.rhsStart.push_back(0);
+    table.productionLhs.push_back(lhs);
+    table.rhsSymbols.insert(table.rhsSymbols.end(), rhs.begin(), rhs.end());
+    table.rhsStart.push_back(table.rhsSymbols.size());
+    return table.productionLhs.size() - 1;
+}
+
+// Function to (re)fill the dense row of one non-terminal from its productions,
+// together with its synchronization set.
+// productionIds lists the table productions of its alternatives in order.
+void fillParseTableRow(ParseTable& table, const FirstFollowSet& ff, int nonTerminal,
+                       const vector<int>& productionIds, vector<string>& conflicts) {
+    int row = table.nonTerminalRow[nonTerminal];
+    uint16_t* cells = table.cells.data() + (size_t)row * table.columns;
+    for (int column = 0; column < table.columns; ++column) cells[column] = NO_PRODUCTION;
+
+    const TerminalSets& suffixSets = ff.suffixSets();
+    const TerminalSets& followSets = ff.followSets();
+
+    // Terminal bits are table columns, so FOLLOW is copied word for word
+    uint64_t* sync = table.syncSets.data() + (size_t)row * table.syncWords;
+    const uint64_t* follow = followSets.row(nonTerminal);
+    for (int i = 0; i < table.syncWords; ++i) sync[i] = follow[i];
+    int endColumn = table.terminalColumn[END_MARKER_ID];
+    sync[0] &= ~(1ULL << EPSILON_BIT);
+    sync[endColumn >> 6] |= 1ULL << (endColumn & 63);
+    TerminalSets predict(1, table.columns);
+    for (size_t k = 0; k < productionIds.size(); ++k) {
+        // Predict set: FIRST of the right-hand side, plus FOLLOW if it can derive ε
+        int index = productionIds[k];
+        uint32_t first = ff.suffixAt(nonTerminal, k, 0);
+        predict.clear(0);
+        predict.unite(0, suffixSets.row(first), false);
+        if (suffixSets.test(first, EPSILON_BIT)) predict.unite(0, followSets.row(nonTerminal), false);
+
+        predict.forEach(0, [&](int column) {
+            uint16_t& cell = cells[column];
+            if (cell != NO_PRODUCTION && cell != index) {
+                conflicts.push_back("[" + table.symbols.name(nonTerminal) + ", " +
+                                    table.symbols.name(table.columnSymbol[column]) + "]: " +
+                                    table.productionText(cell) + " / " + table.productionText(index));
+                return;
+            }
+            cell = index;
+        });
+    }
+}
+
+// Function to construct the LL(1) parsing table from computed FIRST and FOLLOW sets.
+// Returns false, leaving the table empty, if the productions do not fit in 16-bit ids.
+bool buildParseTable(const FirstFollowSet& ff, ParseTable& table, bool compress = false) {
+    table = ParseTable();
+    table.symbols = ff.getSymbols();
+    table.startSymbol = ff.getStartSymbol();
+
+    int symbolCount = table.symbols.size();
+    table.nonTerminalRow.assign(symbolCount, -1);
+    table.terminalColumn.assign(symbolCount, -1);
+    for (int symbol : ff.getNonTerminals()) {
+        table.nonTerminalRow[symbol] = table.rows++;
+        table.rowSymbol.push_back(symbol);
+    }
+    table.columns = ff.terminalCount();
+    for (int column = 0; column < table.columns; ++column) {
+        table.terminalColumn[ff.terminalAt(column)] = column;
+        table.columnSymbol.push_back(ff.terminalAt(column));
+    }
+    table.cells.assign((size_t)table.rows * table.columns, NO_PRODUCTION);
+    table.syncWords = (table.columns + 63) / 64;
+    table.syncSets.assign((size_t)table.rows * table.syncWords, 0);
+
+    vector<int> productionIds;
+    for (int nonTerminal : ff.getNonTerminals()) {
+        productionIds.clear();
+        for (SymbolSpan production : ff.alternatives(nonTerminal)) {
+            int index = addTableProduction(table, nonTerminal, production);
+            if (index < 0) {
+                table = ParseTable();
+                return false;
+            }
+            productionIds.push_back(index);
+        }
+        fillParseTableRow(table, ff, nonTerminal, productionIds, table.conflicts);
+    }
+
+    if (compress) compressParseTable(table);
+    return true;
+}
+
+// Function to write the parsing table as a text grid (columns in terminal order)
+void writeParseTable(const ParseTable& table, ostream& out) {
+    out << setw(15) << "Non-Terminal";
+    for (int column = 1; column < table.columns; ++column) {
+        out << setw(15) << table.symbols.name(table.columnSymbol[column]);
+    }
+    out << endl;
+
+    for (int row = 0; row < table.rows; ++row) {
+        out << setw(15) << table.symbols.name(table.rowSymbol[row]);
+        for (int column = 1; column < table.columns; ++column) {
+            uint16_t production = table.lookup(row, column);
+            out << setw(15) << (production == NO_PRODUCTION ? "" : table.productionText(production));
+        }
+        out << endl;
+    }
+}
+
+// Helper function to print the LL(1) parsing table
+void printParsingTable(const ParseTable& table) {
+    writeParseTable(table, cout);
+    for (const string& conflict : table.conflicts) {
+        cerr << "LL(1) conflict at " << conflict << endl;
+    }
+}
+
+void saveParsingTableToFile(const ParseTable& table, const string& filename) {
+    ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        cerr << "Error: Could not open file " << filename << " for writing." << endl;
+        return;
+    }
+    writeParseTable(table, outFile);
+    outFile.close();
+    cout << "Parsing table saved to: " << filename << endl;
+}
@@ -0,0 +1,128 @@
+// Concrete syntax trees stored as parallel arrays (structure of arrays)
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include "ParseTable.cpp"
+using namespace std;
+
+// Parse tree with one entry per node in every array. Expanding a node by a
+// production appends one child per right-hand side symbol, so the children of
+// a node are contiguous and ordered like the table's rhsSymbols. Node 0 is the
+// root. The arrays keep their capacity across clear(), so they serve as the
+// per-parse arena: once warmed up, building a tree does not allocate.
+struct ParseTree {
+    vector<int> symbol;            // grammar symbol id
+    vector<uint16_t> production;   // production expanded at the node (NO_PRODUCTION for terminals)
+    vector<int> parent;            // -1 for the root
+    vector<int> firstChild;        // -1 for leaves and ε expansions
+    vector<int> nextSibling;       // -1 for the last child
+    vector<uint32_t> tokenBegin;   // tokens [tokenBegin, tokenEnd) the node covers
+    vector<uint32_t> tokenEnd;
+
+    size_t size() const { return symbol.size(); }
+    bool empty() const { return symbol.empty(); }
+    bool isTerminal(int node) const { return production[node] == NO_PRODUCTION; }
+
+    // Function to drop every node while keeping the storage for the next parse
+    void clear() {
+        symbol.clear();
+        production.clear();
+        parent.clear();
+        firstChild.clear();
+        nextSibling.clear();
+        tokenBegin.clear();
+        tokenEnd.clear();
+    }
+
+    // Function to append one node; returns its index
+    int addNode(int nodeSymbol, int nodeParent, int sibling) {
+        symbol.push_back(nodeSymbol);
+        production.push_back(NO_PRODUCTION);
+        parent.push_back(nodeParent);
+        firstChild.push_back(-1);
+        nextSibling.push_back(sibling);
+        tokenBegin.push_back(0);
+        tokenEnd.push_back(0);
+        return symbol.size() - 1;
+    }
+
+    // Function to record that node was expanded by a production at token position;
+    // returns the index of its first child (children follow rhs order)
+    int expand(int node, uint16_t productionId, const int* rhs, int count, uint32_t position) {
+        int first = symbol.size();
+        production[node] = productionId;
+        firstChild[node] = count ? first : -1;
+        tokenBegin[node] = position;
+        for (int i = 0; i < count; ++i) addNode(rhs[i], node, i + 1 < count ? first + i + 1 : -1);
+        return first;
+    }
+
+    // Function to record that a terminal node matched the token at position
+    void match(int node, uint32_t position) {
+        tokenBegin[node] = position;
+        tokenEnd[node] = position + 1;
+    }
+
+    // Function to close the token spans once the parse is accepted. Children always
+    // come after their parent, so one backward pass sees every child first.
+    void finishSpans() {
+        for (int node = (int)size() - 1; node >= 0; --node) {
+            if (isTerminal(node)) continue;
+            int last = firstChild[node];
+            if (last < 0) {
+                tokenEnd[node] = tokenBegin[node];
+                continue;
+            }
+            while (nextSibling[last] >= 0) last = nextSibling[last];
+            tokenEnd[node] = tokenEnd[last];
+        }
+    }
+
+    // Function to call f(child) for every child of a node, in order
+    template <typename F>
+    void forEachChild(int node, F f) const {
+        for (int child = firstChild[node]; child >= 0; child = nextSibling[child]) f(child);
+    }
+
+    // Function to walk the tree depth first without allocating: enter(node, depth)
+    // runs before a node's children and leave(node, depth) after them
+    template <typename Enter, typename Leave>
+    void walk(Enter enter, Leave leave) const {
+        if (empty()) return;
+        int node = 0, depth = 0;
+        for (;;) {
+            enter(node, depth);
+            if (firstChild[node] >= 0) {
+                node = firstChild[node];
+                ++depth;
+                continue;
+            }
+            // Leave finished nodes until one has a next sibling
+            for (;;) {
+                leave(node, depth);
+                if (node == 0) return;
+                if (nextSibling[node] >= 0) {
+                    node = nextSibling[node];
+                    break;
+                }
+                node = parent[node];
+                --depth;
+            }
+        }
+    }
+};
+
+// Function to print a parse tree as an indented outline ("ε" marks empty expansions)
+void writeParseTree(const ParseTree& tree, const ParseTableView& table, ostream& out) {
+    tree.walk(
+        [&](int node, int depth) {
+            for (int i = 0; i < depth; ++i) out << "  ";
+            out << table.name(tree.symbol[node]);
+            if (!tree.isTerminal(node) && tree.firstChild[node] < 0) out << " -> ε";
+            out << "  [" << tree.tokenBegin[node] << ", " << tree.tokenEnd[node] << ")\n";
+        },
+        [](int, int) {});
+}
@@ -0,0 +1,151 @@
+// Emitter of a direct-coded recursive descent parser from the LL(1) table: one
+// function per non-terminal that switches on the lookahead terminal id, with
+// tail-recursive non-terminals (A -> + T A | ε) turned into loops. Every other
+// nesting level is a C++ call, so the parser rejects input nested deeper than its
+// depth limit instead of overflowing the stack.
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include "ParseTable.cpp"
+using namespace std;
+
+// Helper function to name the generated function of a table row
+string emittedFunctionName(const ParseTable& table, int row) {
+    string name = "parse_";
+    for (char c : table.symbols.name(table.rowSymbol[row])) {
+        name += isalnum((unsigned char)c) ? c : '_';
+    }
+    return name + "_" + to_string(row);
+}
+
+// Helper function to write a C string literal (names are plain UTF-8)
+string emittedString(const string& text) {
+    string literal = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') literal += '\\';
+        literal += c;
+    }
+    return literal + "\"";
+}
+
+// Function to write C++ source for a direct-coded parser of the table's grammar.
+// Token ids are the table's symbol ids, so tokenizeText output can be passed as is.
+void emitDirectParser(const ParseTable& table, ostream& out, const string& className = "DirectParser") {
+    out << "// Generated from an LL(1) parse table. Do not edit.\n"
+        << "// Start symbol: " << table.symbols.name(table.startSymbol) << "\n\n"
+        << "#pragma once\n#include <cstddef>\n\n"
+        << "class " << className << " {\n"
+        << "private:\n"
+        << "    const int* tokens = nullptr;\n"
+        << "    size_t count = 0;\n"
+        << "    size_t position = 0;\n"
+        << "    size_t depthLimit;\n"
+        << "    bool tooDeep = false;\n\n"
+        << "    int peek() const { return position < count ? tokens[position] : " << END_MARKER_ID << "; }\n\n"
+        << "    bool match(int terminal) {\n"
+        << "        if (peek() != terminal) return false;\n"
+        << "        ++position;\n"
+        << "        return true;\n"
+        << "    }\n\n"
+        << "    bool nestedTooDeep() {\n"
+        << "        tooDeep = true;\n"
+        << "        return false;\n"
+        << "    }\n";
+
+    for (int row = 0; row < table.rows; ++row) {
+        int nonTerminal = table.rowSymbol[row];
+
+        // Group the columns of the row by the production they predict
+        vector<int> productions;
+        vector<vector<int>> columnsOf(table.productionLhs.size());
+        for (int column = 1; column < table.columns; ++column) {
+            uint16_t production = table.lookup(row, column);
+            if (production == NO_PRODUCTION) continue;
+            if (columnsOf[production].empty()) productions.push_back(production);
+            columnsOf[production].push_back(column);
+        }
+
+        bool loops = false;
+        for (int production : productions) {
+            int length = table.rhsLength(production);
+            if (length > 0 && table.rhsSymbols[table.rhsStart[production + 1] - 1] == nonTerminal) loops = true;
+        }
+
+        string indent = loops ? "            " : "        ";
+        out << "\n    // " << table.symbols.name(nonTerminal) << "\n"
+            << "    bool " << emittedFunctionName(table, row) << "(size_t depth) {\n"
+            << "        if (depth > depthLimit) return nestedTooDeep();\n";
+        if (loops) out << "        for (;;) {\n";
+        out << indent << "switch (peek()) {\n";
+        for (int production : productions) {
+            for (int column : columnsOf[production]) {
+                out << indent << "case " << table.columnSymbol[column] << ":  // "
+                    << table.symbols.name(table.columnSymbol[column]) << "\n";
+            }
+            out << indent << "    // " << table.productionText(production) << "\n";
+
+            int begin = table.rhsStart[production], end = table.rhsStart[production + 1];
+            bool tail = end > begin && table.rhsSymbols[end - 1] == nonTerminal;
+            if (tail) --end;
+            for (int i = begin; i < end; ++i) {
+                int symbol = table.rhsSymbols[i];
+                int symbolRow = table.nonTerminalRow[symbol];
+                if (symbolRow >= 0) {
+                    out << indent << "    if (!" << emittedFunctionName(table, symbolRow) << "(depth + 1)) return false;\n";
+                } else {
+                    out << indent << "    if (!match(" << symbol << ")) return false;  // "
+                        << table.symbols.name(symbol) << "\n";
+                }
+            }
+            out << indent << (tail ? "    continue;\n" : "    return true;\n");
+        }
+        out << indent << "default:\n"
+            << indent << "    return false;\n"
+            << indent << "}\n";
+        if (loops) out << "        }\n";
+        out << "    }\n";
+    }
+
+    out << "\npublic:\n"
+        << "    static const int symbolCount = " << table.symbols.size() << ";\n\n"
+        << "    // Constructor: input nested deeper than depthLimit non-terminal calls is rejected\n"
+        << "    explicit " << className << "(size_t limit = 10000) : depthLimit(limit) {}\n\n"
+        << "    // Function to tell whether the last input was rejected for nesting too deeply\n"
+        << "    bool exceededDepth() const { return tooDeep; }\n\n"
+        << "    // Symbol names by id, to check the parser against the table it came from\n"
+        << "    static const char* symbolName(int id) {\n"
+        << "        static const char* const names[] = {";
+    for (int id = 0; id < table.symbols.size(); ++id) {
+        out << (id ? ", " : "") << emittedString(table.symbols.name(id));
+    }
+    out << "};\n"
+        << "        return names[id];\n"
+        << "    }\n\n"
+        << "    // Function to parse a complete token sequence\n"
+        << "    bool parse(const int* input, size_t length) {\n"
+        << "        tokens = input;\n"
+        << "        count = length;\n"
+        << "        position = 0;\n"
+        << "        tooDeep = false;\n"
+        << "        return " << emittedFunctionName(table, table.nonTerminalRow[table.startSymbol])
+        << "(1) && position == count;\n"
+        << "    }\n"
+        << "};\n";
+}
+
+// Function to write the direct-coded parser to a file
+bool saveDirectParser(const ParseTable& table, const string& filename, const string& className = "DirectParser") {
+    ofstream out(filename);
+    if (!out.is_open()) {
+        cerr << "Error: Could not open file " << filename << " for writing." << endl;
+        return false;
+    }
+    emitDirectParser(table, out, className);
+    out.close();
+    cout << "Direct-coded parser saved to: " << filename << endl;
+    return true;
+}
@@ -0,0 +1,188 @@
+// Library-level grammar pipeline: load -> left factor -> remove left recursion
+// -> FIRST/FOLLOW -> LL(1) table, with every stage handing its result to the
+// next one in memory. File dumps are optional debug output.
+
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <map>
+#include <memory>
+#include "leftFactoring.cpp"
+#include "leftRecursion.cpp"
+#include "FirstFollow.cpp"
+#include "ParseTable.cpp"
+#include "ArtifactCache.cpp"
+#include "PipelineStats.cpp"
+
+using namespace std;
+
+struct PipelineOptions {
+    bool dumpFiles = false;      // write tempLeftFactored.txt, finalGrammar.txt, FirstSets.txt, FollowSets.txt
+    bool compressTable = false;  // store the parse table as a comb vector
+    string cacheDirectory;       // reuse compiled grammars stored here (empty: no cache)
+    int threads = 1;             // workers for FIRST/FOLLOW (<= 0: every hardware thread)
+};
+
+class GrammarPipeline {
+private:
+    PipelineOptions options;
+
+    // Helper function to run one stage and record what it cost
+    template <typename F>
+    auto measure(const string& name, F stage) {
+        StageMeter meter;
+        auto result = stage();
+        stages.push_back(meter.finish(name));
+        return result;
+    }
+
+public:
+    GrammarSource source;                               // productions as loaded (views into the mapped file)
+    Grammar grammar;                                    // grammar as symbol ids, transformed in place
+    int factoredNonTerminals = 0;                       // non-terminals introduced by left factoring
+    int recursionNonTerminals = 0;                      // non-terminals introduced by left recursion removal
+    unique_ptr<FirstFollowSet> sets;
+    ParseTable table;
+    string startSymbol;
+    bool loadedFromCache = false;
+    vector<StageStats> stages;                          // cost of every stage run so far, in order
+
+    // Constructor
+    GrammarPipeline(const PipelineOptions& opts = PipelineOptions()) : options(opts) {}
+
+    // Function to load the grammar file
+    bool load(const string& filename) {
+        if (!measure("load", [&] { return readGrammarFile(filename, source); })) return false;
+        if (source.productions.size() == 0) return false;
+        startSymbol = string(source.productions.lhs[0]);
+        return true;
+    }
+
+    // Function to left factor the loaded productions
+    void factor() {
+        measure("left_factoring", [&] {
+            grammar = grammarFromProductionList(source.productions);
+            return factoredNonTerminals = leftFactoring(grammar);
+        });
+
+        if (options.dumpFiles) {
+            ofstream tempFile("tempLeftFactored.txt");
+            writeGrammar(grammar, tempFile);
+            tempFile.close();
+        }
+    }
+
+    // Function to eliminate direct and indirect left recursion
+    void removeLeftRecursion() {
+        measure("left_recursion", [&] { return recursionNonTerminals = eliminateLeftRecursion(grammar); });
+
+        if (options.dumpFiles) {
+            ofstream outputFile("finalGrammar.txt");
+            outputFile << "Final Grammar after removing left recursion:\n";
+            writeGrammar(grammar, outputFile);
+            outputFile.close();
+        }
+    }
+
+    // Function to compute FIRST and FOLLOW sets. The old sets go first, so dead
+    // arena entries left by the passes can be dropped before the new ones index it.
+    void computeSets() {
+        measure("first", [&] {
+            sets.reset();
+            if (grammar.deadSymbols || grammar.deadAlternatives) grammar.compact();
+            sets.reset(new FirstFollowSet(grammar));
+            sets->setThreads(options.threads);
+            sets->computeAllFirst();
+            return true;
+        });
+        measure("follow", [&] {
+            sets->computeAllFollow();
+            return true;
+        });
+        if (options.dumpFiles) {
+            sets->saveFirstSetsToFile("FirstSets.txt");
+            sets->saveFollowSetsToFile("FollowSets.txt");
+        }
+    }
+
+    // Function to construct the LL(1) parsing table; false if it cannot be built
+    bool buildTable() {
+        if (!measure("table", [&] { return buildParseTable(*sets, table, options.compressTable); })) return false;
+        if (options.dumpFiles) saveParsingTableToFile(table, "parsing_table.txt");
+        return true;
+    }
+
+    // Function to run every stage on a grammar file. With a cache directory,
+    // an unchanged grammar skips straight from loading to the finished table.
+    // Errors are reported here; a grammar without a table is never cached.
+    bool run(const string& filename) {
+        if (!load(filename)) {
+            cerr << "Error: No productions read from " << filename << endl;
+            return false;
+        }
+
+        uint64_t hash = 0;
+        string cacheFile;
+        if (!options.cacheDirectory.empty()) {
+            hash = grammarHash(source.productions);
+            cacheFile = cachePath(options.cacheDirectory, hash);
+            loadedFromCache = measure("cache_load", [&] {
+                return loadArtifacts(cacheFile, hash, grammar, sets, table, factoredNonTerminals, recursionNonTerminals);
+            });
+            if (loadedFromCache) {
+                if (options.compressTable) compressParseTable(table);
+                return true;
+            }
+        }
+
+        factor();
+        removeLeftRecursion();
+        computeSets();
+        if (!buildTable()) {
+            cerr << "Error: No parse table built for " << filename << endl;
+            return false;
+        }
+
+        if (!cacheFile.empty() && !measure("cache_save", [&] {
+                return saveArtifacts(cacheFile, hash, grammar, *sets, table, factoredNonTerminals, recursionNonTerminals);
+            })) {
+            cerr << "Warning: could not write grammar cache " << cacheFile << endl;
+        }
+        return true;
+    }
+};
+
+// Function to write what every stage of a pipeline run cost, and what it produced, as JSON
+void writePipelineStats(const GrammarPipeline& pipeline, ostream& out) {
+    const ParseTable& table = pipeline.table;
+    size_t filled = 0;
+    for (int row = 0; row < table.rows; ++row) {
+        for (int column = 0; column < table.columns; ++column) filled += table.lookup(row, column) != NO_PRODUCTION;
+    }
+    size_t cells = (size_t)table.rows * table.columns;
+    double total = 0;
+    for (const StageStats& stage : pipeline.stages) total += stage.milliseconds;
+    SetSolverStats solver = pipeline.sets ? pipeline.sets->stats() : SetSolverStats();
+
+    out << "{\n  \"grammar\": {\"productions\": " << pipeline.source.productions.size()
+        << ", \"symbols\": " << pipeline.grammar.symbols.size()
+        << ", \"nonTerminals\": " << pipeline.grammar.nonTerminals.size()
+        << ", \"terminals\": " << (pipeline.sets ? pipeline.sets->terminalCount() : 0)
+        << ", \"factoredNonTerminals\": " << pipeline.factoredNonTerminals
+        << ", \"recursionNonTerminals\": " << pipeline.recursionNonTerminals << "},\n"
+        << "  \"loadedFromCache\": " << (pipeline.loadedFromCache ? "true" : "false") << ",\n"
+        << "  \"totalMs\": " << total << ",\n  \"stages\": ";
+    writeStageStats(pipeline.stages, out, "  ");
+    out << ",\n  \"first\": {\"components\": " << solver.firstComponents << ", \"passes\": " << solver.firstPasses << "},\n"
+        << "  \"follow\": {\"components\": " << solver.followComponents << ", \"sweeps\": " << solver.followSweeps << "},\n"
+        << "  \"table\": {\"rows\": " << table.rows << ", \"columns\": " << table.columns
+        << ", \"productions\": " << table.productionLhs.size() << ", \"filledCells\": " << filled
+        << ", \"fillRatio\": " << (cells ? (double)filled / cells : 0.0)
+        << ", \"conflicts\": " << table.conflicts.size() << ", \"compressed\": " << (table.compressed ? "true" : "false")
+        << "},\n  \"heap\": {\"allocations\": " << heapCounters.allocations.load()
+        << ", \"allocatedBytes\": " << heapCounters.allocatedBytes.load()
+        << ", \"liveBytes\": " << heapCounters.liveBytes.load() << "}\n}\n";
+}
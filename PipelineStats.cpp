@@ -0,0 +1,147 @@
+// Per-stage pipeline instrumentation: wall time and heap use of every stage,
+// written as JSON. Heap use comes from counting replacements of the global
+// operator new/delete, so it covers every allocation in the program. Counting
+// is off until countHeapUse(true); until then the replacements cost one relaxed
+// load on top of malloc/free.
+
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(_MSC_VER)
+#include <malloc.h>
+#endif
+using namespace std;
+
+// Live heap counters, updated by every operator new/delete in the program while enabled
+struct HeapCounters {
+    atomic<bool> enabled{false};
+    atomic<uint64_t> allocations{0};
+    atomic<uint64_t> allocatedBytes{0};
+    atomic<int64_t> liveBytes{0};
+    atomic<int64_t> peakBytes{0};
+};
+
+inline HeapCounters heapCounters;
+
+// Function to get the real size of a malloc'd block, so frees can be subtracted
+// without storing a header in front of every allocation
+inline size_t heapBlockSize(void* block) {
+#if defined(__GLIBC__)
+    return malloc_usable_size(block);
+#elif defined(__APPLE__)
+    return malloc_size(block);
+#elif defined(_MSC_VER)
+    return _msize(block);
+#else
+    (void)block;
+    return 0;
+#endif
+}
+
+inline void* countedAllocate(size_t size) {
+    void* block = malloc(size ? size : 1);
+    if (!block) throw bad_alloc();
+    if (!heapCounters.enabled.load(memory_order_relaxed)) return block;
+    int64_t bytes = heapBlockSize(block);
+    heapCounters.allocations.fetch_add(1, memory_order_relaxed);
+    heapCounters.allocatedBytes.fetch_add(bytes ? bytes : size, memory_order_relaxed);
+    int64_t live = heapCounters.liveBytes.fetch_add(bytes, memory_order_relaxed) + bytes;
+    int64_t peak = heapCounters.peakBytes.load(memory_order_relaxed);
+    while (live > peak && !heapCounters.peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+    }
+    return block;
+}
+
+inline void countedFree(void* block) {
+    if (!block) return;
+    if (heapCounters.enabled.load(memory_order_relaxed)) heapCounters.liveBytes.fetch_sub(heapBlockSize(block), memory_order_relaxed);
+    free(block);
+}
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void operator delete(void* block) noexcept { countedFree(block); }
+void operator delete[](void* block) noexcept { countedFree(block); }
+void operator delete(void* block, size_t) noexcept { countedFree(block); }
+void operator delete[](void* block, size_t) noexcept { countedFree(block); }
+
+// Function to turn heap counting on or off. Stages only compare counters taken
+// while it is on; freeing a block allocated before can leave liveBytes below 0.
+inline void countHeapUse(bool enabled) {
+    heapCounters.enabled.store(enabled, memory_order_relaxed);
+}
+
+// Cost of one pipeline stage
+struct StageStats {
+    string name;
+    double milliseconds = 0;
+    uint64_t allocations = 0;     // operator new calls during the stage
+    uint64_t allocatedBytes = 0;  // bytes those calls asked for (block sizes)
+    int64_t peakBytes = 0;        // highest live heap during the stage, above the live heap at its start
+    int64_t retainedBytes = 0;    // live heap added by the stage (negative if it freed more)
+};
+
+// Measurement of one stage; finish() fills in its StageStats
+class StageMeter {
+private:
+    chrono::steady_clock::time_point start;
+    uint64_t allocations, allocatedBytes;
+    int64_t liveBytes;
+
+public:
+    StageMeter() {
+        liveBytes = heapCounters.liveBytes.load(memory_order_relaxed);
+        heapCounters.peakBytes.store(liveBytes, memory_order_relaxed);
+        allocations = heapCounters.allocations.load(memory_order_relaxed);
+        allocatedBytes = heapCounters.allocatedBytes.load(memory_order_relaxed);
+        start = chrono::steady_clock::now();
+    }
+
+    StageStats finish(const string& name) const {
+        StageStats stage;
+        stage.name = name;
+        stage.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        stage.allocations = heapCounters.allocations.load(memory_order_relaxed) - allocations;
+        stage.allocatedBytes = heapCounters.allocatedBytes.load(memory_order_relaxed) - allocatedBytes;
+        stage.peakBytes = heapCounters.peakBytes.load(memory_order_relaxed) - liveBytes;
+        stage.retainedBytes = heapCounters.liveBytes.load(memory_order_relaxed) - liveBytes;
+        return stage;
+    }
+};
+
+// Function to quote a string for JSON
+string jsonString(const string& text) {
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        if ((unsigned char)c < 0x20) {
+            quoted += ' ';
+            continue;
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Function to write stage costs as a JSON array
+void writeStageStats(const vector<StageStats>& stages, ostream& out, const string& indent) {
+    out << "[";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const StageStats& stage = stages[i];
+        out << (i ? "," : "") << "\n" << indent << "  {\"name\": " << jsonString(stage.name)
+            << ", \"ms\": " << stage.milliseconds << ", \"allocations\": " << stage.allocations
+            << ", \"allocatedBytes\": " << stage.allocatedBytes << ", \"peakBytes\": " << stage.peakBytes
+            << ", \"retainedBytes\": " << stage.retainedBytes << "}";
+    }
+    out << "\n" << indent << "]";
+}
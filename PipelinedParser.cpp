@@ -0,0 +1,137 @@
+// Lexer/parser pipelining for large inputs: one thread tokenizes the mapped file
+// into batches of terminal ids while the calling thread runs the LL(1) engine on
+// the batches already done. The batches travel through a bounded SPSC ring, so
+// the tokenizer blocks when the parser falls behind.
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include "StreamParser.cpp"
+#include "MappedFile.cpp"
+#include "SpscRing.cpp"
+using namespace std;
+
+const int INPUT_BREAK = -2;  // token that ends one input inside a batch (line mode)
+
+struct TokenBatch {
+    vector<int> tokens;         // terminal ids (-1 for unknown tokens) and INPUT_BREAKs
+    vector<size_t> inputLines;  // line number of every INPUT_BREAK, in order
+    bool last = false;          // no batch follows this one
+
+    void clear() {
+        tokens.clear();
+        inputLines.clear();
+        last = false;
+    }
+};
+
+// Function to cut text into token batches of at most options.batchTokens entries.
+// nextBatch() returns an empty batch to fill and sendBatch() passes it on; the
+// final batch is sent with last set.
+template <typename Next, typename Send>
+void produceTokenBatches(const ParseTableView& table, string_view text, const StreamOptions& options, Next nextBatch,
+                         Send sendBatch) {
+    size_t limit = max<size_t>(1, options.batchTokens);
+    TokenBatch* batch = &nextBatch();
+    auto makeRoom = [&] {
+        if (batch->tokens.size() < limit) return;
+        sendBatch();
+        batch = &nextBatch();
+    };
+
+    size_t line = 1;
+    for (size_t position = 0; position < text.size(); ++line) {
+        size_t end = options.linePerInput ? text.find('\n', position) : text.size();
+        if (end == string_view::npos) end = text.size();
+        string_view piece = text.substr(position, end - position);
+        bool hasTokens = false;
+        for (size_t i = 0; i < piece.size();) {
+            makeRoom();
+            size_t before = batch->tokens.size();
+            i = options.lexer ? options.lexer->tokenize(piece, i, batch->tokens, limit)
+                              : tokenizeText(table, piece, i, batch->tokens, limit);
+            hasTokens = hasTokens || batch->tokens.size() > before;
+        }
+        if (options.linePerInput && hasTokens) {
+            makeRoom();
+            batch->tokens.push_back(INPUT_BREAK);
+            batch->inputLines.push_back(line);
+        }
+        position = end + 1;
+    }
+    batch->last = true;
+    sendBatch();
+}
+
+// Function to parse a file by token batches: with options.pipelined the batches are
+// tokenized on a second thread, otherwise tokenizing and parsing alternate on this
+// one. onInput receives the line number (0 for a whole-file input) and the verdict.
+ParseStats pipelinedParseFile(const ParseTableView& table, const string& filename, const StreamOptions& options,
+                              const function<void(size_t, bool)>& onInput) {
+    ParseStats stats;
+    MappedFile file;
+    if (!file.open(filename)) {
+        cerr << "Error: " << file.error() << endl;
+        return stats;
+    }
+    string_view text(file.data(), file.size());
+
+    LL1ParseEngine engine(table);
+    auto consume = [&](const TokenBatch& batch) {
+        size_t breaks = 0;
+        for (int token : batch.tokens) {
+            if (token != INPUT_BREAK) {
+                engine.feed(token);
+                continue;
+            }
+            bool accepted = engine.finish();
+            stats.inputs++;
+            stats.accepted += accepted;
+            onInput(batch.inputLines[breaks++], accepted);
+            engine.reset();
+        }
+        stats.tokens += batch.tokens.size() - breaks;
+    };
+
+    auto start = chrono::steady_clock::now();
+    if (!options.pipelined) {
+        TokenBatch batch;
+        produceTokenBatches(
+            table, text, options, [&]() -> TokenBatch& { batch.clear(); return batch; }, [&] { consume(batch); });
+    } else {
+        SpscRing<TokenBatch> ring(options.ringBatches);
+        thread tokenizer([&] {
+            produceTokenBatches(
+                table, text, options,
+                [&]() -> TokenBatch& {
+                    TokenBatch& batch = ring.claim();
+                    batch.clear();
+                    return batch;
+                },
+                [&] { ring.publish(); });
+        });
+        for (bool last = false; !last;) {
+            const TokenBatch& batch = ring.peek();
+            consume(batch);
+            last = batch.last;
+            ring.release();
+        }
+        tokenizer.join();
+        stats.fullRingWaits = ring.fullWaits();
+        stats.emptyRingWaits = ring.emptyWaits();
+    }
+    if (!options.linePerInput) {
+        bool accepted = engine.finish();
+        stats.inputs++;
+        stats.accepted += accepted;
+        onInput(0, accepted);
+    }
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return stats;
+}
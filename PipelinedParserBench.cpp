@@ -0,0 +1,78 @@
+// Benchmark of lexer/parser pipelining: the same file parsed by token batches on
+// one thread and with the tokenizer on a second thread, best of several rounds.
+//
+//   g++ -std=c++17 -O2 -pthread PipelinedParserBench.cpp -o pipelinebench
+//   pipelinebench [--grammar cfg.txt | --builtin] [--lex-spec cfg.lex] [--whole] [--repeat N]
+//                 [--batch TOKENS] [--ring BATCHES] input.txt
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Pipeline.cpp"
+#include "PipelinedParser.cpp"
+#include "CompiledGrammar.cpp"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string filename = "cfg.txt";
+    string inputFile, lexSpec;
+    bool builtin = false;
+    int repeat = 5;
+    StreamOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--grammar" && i + 1 < argc) filename = argv[++i];
+        else if (arg == "--builtin") builtin = true;
+        else if (arg == "--lex-spec" && i + 1 < argc) lexSpec = argv[++i];
+        else if (arg == "--whole") options.linePerInput = false;
+        else if (arg == "--repeat" && i + 1 < argc) repeat = max(1, stoi(argv[++i]));
+        else if (arg == "--batch" && i + 1 < argc) options.batchTokens = stoul(argv[++i]);
+        else if (arg == "--ring" && i + 1 < argc) options.ringBatches = stoul(argv[++i]);
+        else inputFile = arg;
+    }
+
+    GrammarPipeline pipeline;
+    ParseTableView table = EXPRESSION_GRAMMAR.view();
+    if (!builtin) {
+        if (!pipeline.run(filename)) return 1;
+        table = pipeline.table.view();
+    }
+    DfaLexer lexer;
+    if (!lexSpec.empty()) {
+        vector<LexRule> rules;
+        if (lexSpec != "-" && !loadLexerSpec(lexSpec, rules)) return 1;
+        if (!lexer.build(table, rules)) {
+            cerr << "Error: " << lexer.error() << endl;
+            return 1;
+        }
+        options.lexer = &lexer;
+    }
+
+    // Best of repeat rounds per mode; the verdicts must agree between modes
+    auto best = [&](bool pipelined, ParseStats& result) {
+        options.pipelined = pipelined;
+        double seconds = 1e300;
+        for (int r = 0; r < repeat; ++r) {
+            result = pipelinedParseFile(table, inputFile, options, [](size_t, bool) {});
+            seconds = min(seconds, result.seconds);
+        }
+        return seconds;
+    };
+    ParseStats single, piped;
+    double singleSeconds = best(false, single), pipedSeconds = best(true, piped);
+    if (single.inputs == 0) return 1;
+
+    cout << single.inputs << " inputs, " << single.tokens << " tokens, " << repeat << " rounds, "
+         << thread::hardware_concurrency() << " hardware threads\n"
+         << "one thread:  " << (size_t)(single.tokens / singleSeconds) << " tokens/s\n"
+         << "pipelined:   " << (size_t)(piped.tokens / pipedSeconds) << " tokens/s (tokenizer waited "
+         << piped.fullRingWaits << " times, parser " << piped.emptyRingWaits << " times)\n"
+         << "speedup:     " << singleSeconds / pipedSeconds << "x\n";
+    if (single.accepted != piped.accepted || single.tokens != piped.tokens) {
+        cerr << "Error: the two modes disagree" << endl;
+        return 1;
+    }
+    return 0;
+}
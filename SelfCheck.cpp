@@ -0,0 +1,353 @@
+// Regression checks for the grammar pipeline: every check runs a fast path and
+// its reference on the same grammar and compares the results.
+//
+//   g++ -std=c++17 -O2 -pthread SelfCheck.cpp -o selfcheck
+//   selfcheck       (prints PASS or FAIL per check; exit status 1 if any failed)
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <filesystem>
+#include "Pipeline.cpp"
+#include "IncrementalGrammar.cpp"
+#include "ParseEngine.cpp"
+#include "GrammarGenerator.cpp"
+#include "CompiledGrammar.cpp"
+#include "ParserEmitter.cpp"
+#include "GeneratedParser.cpp"
+
+using namespace std;
+
+// Helper function to run the set and table stages on a grammar built in memory
+bool runStages(GrammarPipeline& pipeline, const Grammar& grammar) {
+    pipeline.grammar = grammar;
+    pipeline.computeSets();
+    return pipeline.buildTable();
+}
+
+// Function to check an edit that makes the grammar arena compact itself: the only
+// alternative of a long rule is replaced by two short ones, which moves the rules after it
+bool checkCompactingEdit() {
+    string longRule;
+    for (int i = 0; i < 3000; ++i) longRule += " a";
+    GrammarPipeline pipeline;
+    if (!runStages(pipeline, grammarFromProductions({"S", "L", "R"}, {"L R", longRule, "L c"}))) return false;
+    IncrementalGrammar incremental(pipeline);
+    EditReport report;
+    for (const string& rule : {string("L -> a | c"), "L ->" + longRule, string("L -> a S | ε")}) {
+        if (!incremental.edit(rule, report) || report.fullRebuild || !incremental.matchesFullRebuild()) return false;
+    }
+    return true;
+}
+
+// Function to check that repeated edits do not run out of 16-bit production ids
+bool checkManyEdits() {
+    GrammarPipeline pipeline;
+    if (!pipeline.run("cfg.txt")) return false;
+    IncrementalGrammar incremental(pipeline);
+    EditReport report;
+    for (int i = 0; i < 40000; ++i) {
+        if (!incremental.edit(i % 2 ? "A -> + T A | ε" : "A -> ε | + T A", report) || report.fullRebuild) return false;
+    }
+    return incremental.matchesFullRebuild() && pipeline.table.productionLhs.size() < 4096;
+}
+
+// Function to check edits that leave cfg.txt as it was, each checked against a full
+// rebuild as temp --edit does: neither the edits nor the checks may compact the grammar
+bool checkIdentityEdits() {
+    GrammarPipeline pipeline;
+    if (!pipeline.run("cfg.txt")) return false;
+    IncrementalGrammar incremental(pipeline);
+    EditReport report;
+    uint32_t compactions = pipeline.grammar.compactions;
+    for (int round = 0; round < 3; ++round) {
+        for (const char* rule : {"A -> + T A | ε", "B -> * F B | ε", "T -> F B", "F -> ( E ) | id", "E -> T A",
+                                 "A -> ε | + T A"}) {
+            if (!incremental.edit(rule, report) || report.fullRebuild || !incremental.matchesFullRebuild()) return false;
+        }
+    }
+    return pipeline.grammar.compactions == compactions;
+}
+
+// Function to check that a table whose last row id is the comb vector's free marker
+// reads the same with compression asked for as without. Row X (0xFFFF) is placed
+// early as it has the most cells; its slots must not look free to row Y after it.
+bool checkCompressedRowLimit() {
+    string text = "S -> X\nY -> a\n";
+    for (int i = 2; i < NO_PRODUCTION; ++i) text += "E" + to_string(i) + " ->\n";
+    text += "X -> a | b | c | d\n";
+    ProductionList productions;
+    scanProductions(text, productions);
+    GrammarPipeline dense, compressed;
+    dense.grammar = grammarFromProductionList(productions);
+    dense.computeSets();
+    compressed.grammar = dense.grammar;
+    compressed.computeSets();
+    if (!buildParseTable(*dense.sets, dense.table) || !buildParseTable(*compressed.sets, compressed.table, true)) {
+        return false;
+    }
+    if (dense.table.rows != NO_PRODUCTION + 1) return false;
+    for (int row = 0; row < dense.table.rows; ++row) {
+        for (int column = 0; column < dense.table.columns; ++column) {
+            if (dense.table.lookup(row, column) != compressed.table.lookup(row, column)) return false;
+        }
+    }
+    return true;
+}
+
+// Function to check that a damaged cache entry is a miss rather than a table that
+// indexes out of bounds: every 32-bit field of the entry for cfg.txt is overwritten in
+// turn with out-of-range values, and whatever still loads is looked up and parsed with
+// (build with -fsanitize=address to catch a stray read)
+bool checkDamagedCache() {
+    string directory = (filesystem::temp_directory_path() / "selfcheck-cache").string();
+    error_code ignored;
+    filesystem::remove_all(directory, ignored);
+    PipelineOptions options;
+    options.cacheDirectory = directory;
+    GrammarPipeline pipeline(options);
+    if (!pipeline.run("cfg.txt")) return false;
+    uint64_t hash = grammarHash(pipeline.source.productions);
+    string path = cachePath(directory, hash);
+    stringstream contents;
+    contents << ifstream(path, ios::binary).rdbuf();
+    string pristine = contents.str();
+
+    bool passed = !pristine.empty();
+    for (size_t at = 16; passed && at + 4 <= pristine.size(); ++at) {
+        for (int32_t value : {-2, 1000, INT32_MAX}) {
+            string damaged = pristine;
+            memcpy(&damaged[at], &value, 4);
+            ofstream(path, ios::binary) << damaged;
+            Grammar grammar;
+            unique_ptr<FirstFollowSet> sets;
+            ParseTable table;
+            int factored, recursion;
+            if (!loadArtifacts(path, hash, grammar, sets, table, factored, recursion)) continue;
+            vector<int> tokens;
+            tokenizeLine(table.view(), "id + ( id * id ) )", tokens);
+            LL1ParseEngine engine(table);
+            engine.parse(tokens);
+            for (int row = 0; row < table.rows; ++row) {
+                for (int column = 0; column < table.columns; ++column) {
+                    uint16_t production = table.lookup(row, column);
+                    if (production != NO_PRODUCTION) table.productionText(production);
+                }
+            }
+        }
+    }
+    ofstream(path, ios::binary) << pristine;
+    Grammar grammar;
+    unique_ptr<FirstFollowSet> sets;
+    ParseTable table;
+    int factored, recursion;
+    passed = passed && loadArtifacts(path, hash, grammar, sets, table, factored, recursion);
+    filesystem::remove_all(directory, ignored);
+    return passed;
+}
+
+// Function to check that a grammar with more productions than 16-bit ids gets no table
+bool checkProductionOverflow() {
+    vector<string> lhs(70000, "S"), rhs(70000);
+    for (size_t i = 0; i < rhs.size(); ++i) rhs[i] = "t" + to_string(i % 100) + " S";
+    GrammarPipeline pipeline;
+    return !runStages(pipeline, grammarFromProductions(lhs, rhs)) && pipeline.table.rows == 0;
+}
+
+// Function to check a non-terminal without alternatives: it keeps an empty FIRST set,
+// is not nullable, gets FOLLOW from where it is used and survives being written out,
+// read back and edited
+bool checkEmptyRule() {
+    ProductionList productions;
+    scanProductions("S -> A b | c\nA ->\n", productions);
+    GrammarPipeline pipeline;
+    if (!runStages(pipeline, grammarFromProductionList(productions))) return false;
+    FirstFollowSet& sets = *pipeline.sets;
+    int A = pipeline.grammar.symbols.find("A");
+    if (!sets.isNonTerminal(A) || !sets.first["A"].empty() || sets.follow["A"] != set<string>{"b"}) return false;
+    if (sets.first["S"] != set<string>{"c"}) return false;
+
+    FirstFollowSet reference(pipeline.grammar);
+    reference.computeAllFirst();
+    reference.computeAllFollowIterative();
+    if (reference.follow != sets.follow) return false;
+
+    stringstream written;
+    writeGrammar(pipeline.grammar, written);
+    string text = written.str();
+    ProductionList reread;
+    scanProductions(text, reread);
+    stringstream rewritten;
+    writeGrammar(grammarFromProductionList(reread), rewritten);
+    if (rewritten.str() != text) return false;
+
+    IncrementalGrammar incremental(pipeline);
+    EditReport report;
+    return incremental.edit("A -> d", report) && pipeline.grammar.nonTerminals.size() == 2 &&
+           incremental.matchesFullRebuild();
+}
+
+// Helper function to check the fast FIRST/FOLLOW solvers against the references on
+// one transformed grammar: the sets on one thread and on several must agree bit for
+// bit, and the SCC FOLLOW solver must agree with the sweep to a fixed point
+bool solversAgree(const Grammar& grammar) {
+    PipelineOptions parallel;
+    parallel.threads = 8;
+    GrammarPipeline sequential, threaded(parallel);
+    sequential.grammar = threaded.grammar = grammar;
+    sequential.computeSets();
+    threaded.computeSets();
+    const FirstFollowSet& sets = *sequential.sets;
+    if (sets.firstSets().raw() != threaded.sets->firstSets().raw()) return false;
+    if (sets.followSets().raw() != threaded.sets->followSets().raw()) return false;
+
+    FirstFollowSet reference(sequential.grammar);
+    reference.computeAllFirst();
+    reference.computeAllFollowIterative();
+    return sets.firstSets().raw() == reference.firstSets().raw() &&
+           sets.followSets().raw() == reference.followSets().raw();
+}
+
+// Function to check the solvers on cfg.txt
+bool checkSolversOnFile() {
+    GrammarPipeline pipeline;
+    return pipeline.run("cfg.txt") && solversAgree(pipeline.grammar);
+}
+
+// Function to check the solvers on generated grammars with left recursion cycles
+// and nullable chains, which give FIRST and FOLLOW large strongly connected components
+bool checkSolversOnGenerated() {
+    for (uint64_t seed = 1; seed <= 4; ++seed) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.nonTerminals = 2000;
+        options.sharedPrefix = 30;
+        options.recursionDepth = 1 + seed % 3;
+        options.nullableChain = 4;
+        stringstream text;
+        generateGrammar(options, text);
+        string source = text.str();
+        ProductionList productions;
+        scanProductions(source, productions);
+        Grammar grammar = grammarFromProductionList(productions);
+        leftFactoring(grammar);
+        eliminateLeftRecursion(grammar);
+        if (!solversAgree(grammar)) return false;
+    }
+    return true;
+}
+
+// Helper function to build the run-time table from a grammar text and compare it cell
+// by cell, with its symbols, productions and recovery sets, against a compiled table
+bool compiledMatches(const ParseTableView& compiled, string_view text) {
+    ProductionList productions;
+    scanProductions(text, productions);
+    GrammarPipeline pipeline;
+    if (!runStages(pipeline, grammarFromProductionList(productions))) return false;
+    ParseTableView table = pipeline.table.view();
+    if (table.symbolCount != compiled.symbolCount || table.startSymbol != compiled.startSymbol ||
+        table.rows != compiled.rows || table.columns != compiled.columns ||
+        table.productionCount != compiled.productionCount) {
+        return false;
+    }
+    for (int id = 0; id < table.symbolCount; ++id) {
+        if (table.name(id) != compiled.name(id)) return false;
+    }
+    if (!equal(table.rowSymbol, table.rowSymbol + table.rows, compiled.rowSymbol) ||
+        !equal(table.columnSymbol, table.columnSymbol + table.columns, compiled.columnSymbol) ||
+        !equal(table.productionLhs, table.productionLhs + table.productionCount, compiled.productionLhs) ||
+        !equal(table.rhsStart, table.rhsStart + table.productionCount + 1, compiled.rhsStart) ||
+        !equal(table.rhsSymbols, table.rhsSymbols + table.rhsStart[table.productionCount], compiled.rhsSymbols)) {
+        return false;
+    }
+    for (int row = 0; row < table.rows; ++row) {
+        for (int column = 0; column < table.columns; ++column) {
+            if (table.lookup(row, column) != compiled.lookup(row, column)) return false;
+            if (table.synchronizes(row, column) != compiled.synchronizes(row, column)) return false;
+        }
+    }
+    return true;
+}
+
+// Function to check the compiled-in expression grammar against the run-time table
+bool checkCompiledGrammar() {
+    return compiledMatches(EXPRESSION_GRAMMAR.view(), EXPRESSION_GRAMMAR_TEXT);
+}
+
+// Function to check that the compiler reads text as the grammar reader does: the
+// → arrow, repeated and empty alternatives and a rule declared without alternatives
+constexpr string_view READER_RULES_TEXT =
+    "S → L x | L x | y | | D\n"
+    "L -> ( S ) | ε\n"
+    "L -> ε\n"
+    "D ->\n";
+constexpr auto READER_RULES_GRAMMAR = compileGrammar<16, 16, 32, 64>(READER_RULES_TEXT);
+
+bool checkCompiledReaderRules() {
+    return READER_RULES_GRAMMAR.productionCount == 5 && compiledMatches(READER_RULES_GRAMMAR.view(), READER_RULES_TEXT);
+}
+
+// Function to check that the checked-in GeneratedParser.cpp is what the emitter
+// writes for cfg.txt today
+bool checkGeneratedParser() {
+    GrammarPipeline pipeline;
+    if (!pipeline.run("cfg.txt")) return false;
+    stringstream emitted;
+    emitDirectParser(pipeline.table, emitted);
+    ifstream file("GeneratedParser.cpp");
+    stringstream checkedIn;
+    checkedIn << file.rdbuf();
+    return file && emitted.str() == checkedIn.str();
+}
+
+// Function to check that the direct-coded parser rejects input nested past its depth
+// limit, where the table engine (an explicit stack) still accepts it
+bool checkDirectParserDepth() {
+    GrammarPipeline pipeline;
+    if (!pipeline.run("cfg.txt")) return false;
+    LL1ParseEngine engine(pipeline.table);
+    DirectParser direct;
+    for (int nesting : {100, 1000000}) {
+        string line;
+        for (int i = 0; i < nesting; ++i) line += "( ";
+        line += "id";
+        for (int i = 0; i < nesting; ++i) line += " )";
+        vector<int> tokens;
+        tokenizeLine(pipeline.table.view(), line, tokens);
+        bool deep = nesting > 1000;
+        if (!engine.parse(tokens) || direct.parse(tokens.data(), tokens.size()) == deep) return false;
+        if (direct.exceededDepth() != deep) return false;
+    }
+    return true;
+}
+
+int main() {
+    struct Check {
+        const char* name;
+        bool (*run)();
+    };
+    const Check checks[] = {
+        {"incremental edit that compacts the grammar", checkCompactingEdit},
+        {"40000 incremental edits", checkManyEdits},
+        {"identity edits checked after every edit", checkIdentityEdits},
+        {"production ids overflow", checkProductionOverflow},
+        {"compression of a table with 65536 rows", checkCompressedRowLimit},
+        {"damaged cache entries", checkDamagedCache},
+        {"non-terminal without alternatives", checkEmptyRule},
+        {"FIRST/FOLLOW solvers on cfg.txt", checkSolversOnFile},
+        {"FIRST/FOLLOW solvers on generated grammars", checkSolversOnGenerated},
+        {"compiled expression grammar", checkCompiledGrammar},
+        {"compiled grammar text rules", checkCompiledReaderRules},
+        {"checked-in GeneratedParser.cpp", checkGeneratedParser},
+        {"direct-coded parser depth limit", checkDirectParserDepth},
+    };
+
+    int failed = 0;
+    for (const Check& check : checks) {
+        bool passed = check.run();
+        failed += !passed;
+        cout << (passed ? "PASS  " : "FAIL  ") << check.name << endl;
+    }
+    return failed ? 1 : 0;
+}
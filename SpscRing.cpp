@@ -0,0 +1,83 @@
+// Bounded lock-free ring between exactly one producer thread and one consumer
+// thread. Slots are written and read in place, so their storage (for example a
+// vector's capacity) is reused round after round instead of reallocated.
+
+#pragma once
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+// Function to wait for a condition, spinning briefly before yielding the core
+template <typename Ready>
+void waitUntil(Ready ready) {
+    for (int spins = 0; !ready(); ++spins) {
+        if (spins < 64) {
+#ifdef __SSE2__
+            _mm_pause();
+#endif
+        } else {
+            this_thread::yield();
+        }
+    }
+}
+
+template <typename T>
+class SpscRing {
+private:
+    vector<T> slots;
+    size_t mask;
+    // Each side writes only its own cache line
+    alignas(64) atomic<size_t> head{0};  // next slot to read, advanced by the consumer
+    size_t consumerWaits = 0;
+    alignas(64) atomic<size_t> tail{0};  // next slot to write, advanced by the producer
+    size_t producerWaits = 0;
+
+public:
+    // Constructor: capacity is rounded up to a power of two
+    SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    size_t capacity() const { return slots.size(); }
+
+    // Producer: wait for a free slot (backpressure when the consumer falls behind)
+    // and return it for filling; publish() hands it over
+    T& claim() {
+        size_t t = tail.load(memory_order_relaxed);
+        if (t - head.load(memory_order_acquire) == slots.size()) {
+            producerWaits++;
+            waitUntil([&] { return t - head.load(memory_order_acquire) < slots.size(); });
+        }
+        return slots[t & mask];
+    }
+
+    void publish() {
+        tail.store(tail.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+    // Consumer: wait for a published slot and return it; release() frees it
+    T& peek() {
+        size_t h = head.load(memory_order_relaxed);
+        if (tail.load(memory_order_acquire) == h) {
+            consumerWaits++;
+            waitUntil([&] { return tail.load(memory_order_acquire) != h; });
+        }
+        return slots[h & mask];
+    }
+
+    void release() {
+        head.store(head.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+    // Times the producer found the ring full and the consumer found it empty
+    size_t fullWaits() const { return producerWaits; }
+    size_t emptyWaits() const { return consumerWaits; }
+};
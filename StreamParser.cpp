@@ -0,0 +1,126 @@
+// Streaming parser for inputs larger than memory: the file is read in fixed-size
+// chunks, tokenized across chunk boundaries and fed to the LL(1) engine as it
+// goes, so memory stays constant however large the input is
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <cctype>
+#include <iostream>
+#include <functional>
+#include "ParseEngine.cpp"
+using namespace std;
+
+struct StreamOptions {
+    size_t chunkSize = 1 << 16;  // bytes read at a time
+    bool linePerInput = true;    // every non-empty line is one input; otherwise the whole stream is one
+
+    // Token batch mode (pipelinedParseFile)
+    bool pipelined = false;            // tokenize on a second thread while this one parses
+    size_t batchTokens = 4096;         // tokens per batch
+    size_t ringBatches = 16;           // batches in flight between the two threads
+    const DfaLexer* lexer = nullptr;   // generated lexer; without one, tokens are split at whitespace
+};
+
+// Push tokenizer: takes text a chunk at a time and hands each complete token to
+// the engine. A token cut by a chunk boundary is carried over to the next chunk.
+class StreamTokenizer {
+private:
+    const ParseTableView& table;
+    LL1ParseEngine& engine;
+    string partial;             // start of a token cut off by the end of the previous chunk
+    bool lineHasTokens = false;
+
+    void emit(string_view token) {
+        engine.feed(table.terminalId(token));
+        tokens++;
+        lineHasTokens = true;
+    }
+
+public:
+    size_t tokens = 0;
+    size_t line = 1;            // line the tokenizer has reached
+
+    StreamTokenizer(const ParseTableView& parseTable, LL1ParseEngine& parseEngine)
+        : table(parseTable), engine(parseEngine) {}
+
+    // Function to tokenize one chunk; onLineEnd(line) runs at each newline that closes a non-empty line
+    template <typename LineEnd>
+    void feed(string_view chunk, LineEnd onLineEnd) {
+        size_t i = 0;
+        while (i < chunk.size()) {
+            size_t start = i;
+            while (i < chunk.size() && !isspace((unsigned char)chunk[i])) ++i;
+            if (i == chunk.size()) {
+                partial.append(chunk.data() + start, i - start);
+                return;
+            }
+            if (!partial.empty()) {
+                partial.append(chunk.data() + start, i - start);
+                emit(partial);
+                partial.clear();
+            } else if (i > start) {
+                emit(chunk.substr(start, i - start));
+            }
+
+            for (; i < chunk.size() && isspace((unsigned char)chunk[i]); ++i) {
+                if (chunk[i] != '\n') continue;
+                if (lineHasTokens) {
+                    lineHasTokens = false;
+                    onLineEnd(line);
+                }
+                ++line;
+            }
+        }
+    }
+
+    // Function to flush a token left at the end of the stream; returns true if the last line had tokens
+    bool flush() {
+        if (!partial.empty()) emit(partial);
+        partial.clear();
+        bool open = lineHasTokens;
+        lineHasTokens = false;
+        return open;
+    }
+};
+
+// Function to stream a file through the parse engine. onInput receives the
+// line number (0 for a whole-stream input) and the verdict of each input.
+ParseStats streamParseFile(const ParseTableView& table, const string& filename, const StreamOptions& options,
+                           const function<void(size_t, bool)>& onInput) {
+    ParseStats stats;
+    ifstream file(filename, ios::binary);
+    if (!file) {
+        cerr << "Error: Unable to open file " << filename << endl;
+        return stats;
+    }
+
+    LL1ParseEngine engine(table);
+    StreamTokenizer tokenizer(table, engine);
+    vector<char> buffer(options.chunkSize < 1 ? 1 : options.chunkSize);
+
+    auto finishInput = [&](size_t number) {
+        bool accepted = engine.finish();
+        stats.inputs++;
+        stats.accepted += accepted;
+        onInput(number, accepted);
+        engine.reset();
+    };
+
+    auto start = chrono::steady_clock::now();
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        string_view chunk(buffer.data(), file.gcount());
+        if (chunk.empty()) break;
+
+        if (options.linePerInput) tokenizer.feed(chunk, finishInput);
+        else tokenizer.feed(chunk, [](size_t) {});
+    }
+    if (tokenizer.flush() || !options.linePerInput) finishInput(options.linePerInput ? tokenizer.line : 0);
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.tokens = tokenizer.tokens;
+    return stats;
+}
@@ -0,0 +1,79 @@
+// Symbol table that interns grammar symbols into dense integer ids
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+using namespace std;
+
+// Reserved ids, identical in every table
+const int EPSILON_ID = 0;     // ε
+const int END_MARKER_ID = 1;  // $
+
+class SymbolTable {
+private:
+    // Names live in a deque so the string_view keys pointing at them never move;
+    // lookups by string_view then need no temporary string
+    deque<string> names;
+    unordered_map<string_view, int> ids;
+
+    void addReserved() {
+        intern("ε");
+        intern("$");
+        // Older grammar dumps carry ε as its Latin-1 mojibake
+        ids["Îµ"] = EPSILON_ID;
+    }
+
+public:
+    // Constructor
+    SymbolTable() {
+        addReserved();
+    }
+
+    // Copies rebuild the index so its keys point at the copy's own names
+    SymbolTable(const SymbolTable& other) {
+        *this = other;
+    }
+
+    SymbolTable& operator=(const SymbolTable& other) {
+        if (this == &other) return *this;
+        names.clear();
+        ids.clear();
+        addReserved();
+        for (int id = END_MARKER_ID + 1; id < other.size(); ++id) intern(other.name(id));
+        return *this;
+    }
+
+    SymbolTable(SymbolTable&&) = default;
+    SymbolTable& operator=(SymbolTable&&) = default;
+
+    // Function to get (or create) the id for a symbol name
+    int intern(string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        int id = names.size();
+        names.emplace_back(name);
+        ids.emplace(names.back(), id);
+        return id;
+    }
+
+    // Function to look up a symbol without creating it (-1 if unknown)
+    int find(string_view name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    const string& name(int id) const {
+        return names[id];
+    }
+
+    int size() const {
+        return names.size();
+    }
+
+    // Function to reserve room for a known number of symbols
+    void reserve(size_t count) {
+        ids.reserve(count + 3);
+    }
+};
@@ -0,0 +1,251 @@
+// Binary parse-table image: a versioned, endian-tagged file of 64-byte aligned
+// sections that a parser process maps and runs on directly, with no parsing
+// or copying, so startup cost does not grow with the grammar.
+//
+// Layout: TableImageHeader, then TABLE_IMAGE_SECTIONS directory entries, then
+// the sections themselves in directory order.
+
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include <iostream>
+#include "ParseTable.cpp"
+#include "MappedFile.cpp"
+using namespace std;
+
+static_assert(sizeof(int) == 4, "table images store symbol ids as 32-bit ints");
+
+const char TABLE_IMAGE_MAGIC[4] = {'L', 'L', '1', 'T'};
+const uint32_t TABLE_IMAGE_VERSION = 2;  // 2: synchronization sets
+const uint32_t TABLE_IMAGE_BYTE_ORDER = 0x01020304;  // reads back as 0x04030201 on the other byte order
+const uint64_t TABLE_IMAGE_ALIGNMENT = 64;
+
+enum TableImageSectionId : uint32_t {
+    SECTION_NAME_OFFSETS,
+    SECTION_NAMES,
+    SECTION_NAME_ORDER,
+    SECTION_NONTERMINAL_ROW,
+    SECTION_TERMINAL_COLUMN,
+    SECTION_ROW_SYMBOL,
+    SECTION_COLUMN_SYMBOL,
+    SECTION_PRODUCTION_LHS,
+    SECTION_RHS_START,
+    SECTION_RHS_SYMBOLS,
+    SECTION_CELLS,
+    SECTION_ROW_OFFSET,
+    SECTION_COMB_VALUE,
+    SECTION_COMB_OWNER,
+    SECTION_SYNC_SETS,
+    TABLE_IMAGE_SECTIONS
+};
+
+struct TableImageHeader {
+    char magic[4];
+    uint32_t byteOrder;
+    uint32_t version;
+    uint32_t sectionCount;
+    uint64_t fileSize;
+    int32_t symbolCount;
+    int32_t startSymbol;
+    int32_t rows;
+    int32_t columns;
+    int32_t productionCount;
+    int32_t compressed;
+};
+
+struct TableImageSection {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t offset;   // from the start of the file, a multiple of TABLE_IMAGE_ALIGNMENT
+    uint64_t count;    // elements, not bytes
+};
+
+// Function to write a parse table as a binary image
+bool writeTableImage(const ParseTable& table, const string& filename) {
+    int symbolCount = table.symbols.size();
+
+    // Names back to back, plus the ids sorted by name so lookups can binary search
+    vector<uint32_t> nameOffsets(1, 0);
+    string names;
+    for (int id = 0; id < symbolCount; ++id) {
+        names += table.symbols.name(id);
+        nameOffsets.push_back(names.size());
+    }
+    vector<int> nameOrder(symbolCount);
+    iota(nameOrder.begin(), nameOrder.end(), 0);
+    sort(nameOrder.begin(), nameOrder.end(),
+         [&](int a, int b) { return table.symbols.name(a) < table.symbols.name(b); });
+
+    struct Source {
+        const void* data;
+        uint32_t elementSize;
+        uint64_t count;
+    };
+    Source sources[TABLE_IMAGE_SECTIONS] = {
+        {nameOffsets.data(), 4, nameOffsets.size()},
+        {names.data(), 1, names.size()},
+        {nameOrder.data(), 4, nameOrder.size()},
+        {table.nonTerminalRow.data(), 4, table.nonTerminalRow.size()},
+        {table.terminalColumn.data(), 4, table.terminalColumn.size()},
+        {table.rowSymbol.data(), 4, table.rowSymbol.size()},
+        {table.columnSymbol.data(), 4, table.columnSymbol.size()},
+        {table.productionLhs.data(), 4, table.productionLhs.size()},
+        {table.rhsStart.data(), 4, table.rhsStart.size()},
+        {table.rhsSymbols.data(), 4, table.rhsSymbols.size()},
+        {table.cells.data(), 2, table.cells.size()},
+        {table.rowOffset.data(), 4, table.rowOffset.size()},
+        {table.combValue.data(), 2, table.combValue.size()},
+        {table.combOwner.data(), 2, table.combOwner.size()},
+        {table.syncSets.data(), 8, table.syncSets.size()},
+    };
+
+    TableImageHeader header = {};
+    memcpy(header.magic, TABLE_IMAGE_MAGIC, 4);
+    header.byteOrder = TABLE_IMAGE_BYTE_ORDER;
+    header.version = TABLE_IMAGE_VERSION;
+    header.sectionCount = TABLE_IMAGE_SECTIONS;
+    header.symbolCount = symbolCount;
+    header.startSymbol = table.startSymbol;
+    header.rows = table.rows;
+    header.columns = table.columns;
+    header.productionCount = table.productionLhs.size();
+    header.compressed = table.compressed;
+
+    TableImageSection directory[TABLE_IMAGE_SECTIONS];
+    uint64_t offset = sizeof(TableImageHeader) + sizeof(directory);
+    for (uint32_t id = 0; id < TABLE_IMAGE_SECTIONS; ++id) {
+        offset = (offset + TABLE_IMAGE_ALIGNMENT - 1) / TABLE_IMAGE_ALIGNMENT * TABLE_IMAGE_ALIGNMENT;
+        directory[id] = {id, sources[id].elementSize, offset, sources[id].count};
+        offset += sources[id].elementSize * sources[id].count;
+    }
+    header.fileSize = offset;
+
+    ofstream out(filename, ios::binary);
+    if (!out) {
+        cerr << "Error: Could not open file " << filename << " for writing." << endl;
+        return false;
+    }
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)directory, sizeof(directory));
+    uint64_t written = sizeof(header) + sizeof(directory);
+    const char padding[TABLE_IMAGE_ALIGNMENT] = {};
+    for (uint32_t id = 0; id < TABLE_IMAGE_SECTIONS; ++id) {
+        out.write(padding, directory[id].offset - written);
+        out.write((const char*)sources[id].data, sources[id].elementSize * sources[id].count);
+        written = directory[id].offset + sources[id].elementSize * sources[id].count;
+    }
+    out.close();
+    return (bool)out;
+}
+
+// A table image mapped read-only into memory. view() points straight into the
+// mapping; it stays valid as long as this object lives.
+class MappedTableImage {
+private:
+    MappedFile file;
+    const char* base = nullptr;
+    size_t length = 0;
+    ParseTableView tableView;
+    string errorText;
+
+    bool fail(const string& text) {
+        errorText = text;
+        return false;
+    }
+
+    // Helper function to locate a section, checking it lies inside the file
+    template <typename T>
+    const T* section(const TableImageSection* directory, uint32_t id, uint64_t expectedCount) {
+        const TableImageSection& entry = directory[id];
+        if (entry.id != id || entry.elementSize != sizeof(T) || entry.count != expectedCount ||
+            entry.offset % TABLE_IMAGE_ALIGNMENT != 0 || entry.offset > length ||
+            entry.count * sizeof(T) > length - entry.offset) {
+            return nullptr;
+        }
+        return (const T*)(base + entry.offset);
+    }
+
+public:
+    MappedTableImage() {}
+    MappedTableImage(const MappedTableImage&) = delete;
+    MappedTableImage& operator=(const MappedTableImage&) = delete;
+
+    // Function to map an image. Only the header and section directory are
+    // checked, so the cost is the same for every grammar size.
+    bool open(const string& filename) {
+        tableView = ParseTableView();
+        if (!file.open(filename)) return fail(file.error());
+        base = file.data();
+        length = file.size();
+        if (length < sizeof(TableImageHeader) + TABLE_IMAGE_SECTIONS * sizeof(TableImageSection)) {
+            return fail(filename + " is too short to be a table image");
+        }
+
+        const TableImageHeader& header = *(const TableImageHeader*)base;
+        if (memcmp(header.magic, TABLE_IMAGE_MAGIC, 4) != 0) return fail(filename + " is not a table image");
+        if (header.byteOrder != TABLE_IMAGE_BYTE_ORDER) {
+            return fail(filename + " was written on a machine with a different byte order");
+        }
+        if (header.version != TABLE_IMAGE_VERSION) {
+            return fail(filename + " has table image version " + to_string(header.version) + ", expected " +
+                        to_string(TABLE_IMAGE_VERSION));
+        }
+        if (header.sectionCount != TABLE_IMAGE_SECTIONS || header.fileSize != length) {
+            return fail(filename + " is truncated or damaged");
+        }
+        if (header.symbolCount <= END_MARKER_ID || header.rows < 0 || header.columns < 0 ||
+            header.productionCount < 0 || header.startSymbol < 0 || header.startSymbol >= header.symbolCount) {
+            return fail(filename + " has an invalid header");
+        }
+
+        const TableImageSection* directory = (const TableImageSection*)(base + sizeof(TableImageHeader));
+        const TableImageSection& names = directory[SECTION_NAMES];
+        const TableImageSection& comb = directory[SECTION_COMB_VALUE];
+        uint64_t symbols = header.symbolCount;
+        uint64_t cells = header.compressed ? 0 : (uint64_t)header.rows * header.columns;
+
+        ParseTableView& v = tableView;
+        v = ParseTableView();
+        v.symbolCount = header.symbolCount;
+        v.startSymbol = header.startSymbol;
+        v.rows = header.rows;
+        v.columns = header.columns;
+        v.productionCount = header.productionCount;
+        v.compressed = header.compressed != 0;
+        v.nameOffsets = section<uint32_t>(directory, SECTION_NAME_OFFSETS, symbols + 1);
+        v.names = section<char>(directory, SECTION_NAMES, names.count);
+        v.nameOrder = section<int>(directory, SECTION_NAME_ORDER, symbols);
+        v.nonTerminalRow = section<int>(directory, SECTION_NONTERMINAL_ROW, symbols);
+        v.terminalColumn = section<int>(directory, SECTION_TERMINAL_COLUMN, symbols);
+        v.rowSymbol = section<int>(directory, SECTION_ROW_SYMBOL, header.rows);
+        v.columnSymbol = section<int>(directory, SECTION_COLUMN_SYMBOL, header.columns);
+        v.productionLhs = section<int>(directory, SECTION_PRODUCTION_LHS, header.productionCount);
+        v.rhsStart = section<int>(directory, SECTION_RHS_START, header.productionCount + 1);
+        v.rhsSymbols = section<int>(directory, SECTION_RHS_SYMBOLS, directory[SECTION_RHS_SYMBOLS].count);
+        v.cells = section<uint16_t>(directory, SECTION_CELLS, cells);
+        v.rowOffset = section<int>(directory, SECTION_ROW_OFFSET, v.compressed ? header.rows : 0);
+        v.combValue = section<uint16_t>(directory, SECTION_COMB_VALUE, comb.count);
+        v.combOwner = section<uint16_t>(directory, SECTION_COMB_OWNER, comb.count);
+        v.syncWords = (header.columns + 63) / 64;
+        v.syncSets = section<uint64_t>(directory, SECTION_SYNC_SETS, (uint64_t)header.rows * v.syncWords);
+        if (!v.nameOffsets || !v.names || !v.nameOrder || !v.nonTerminalRow || !v.terminalColumn ||
+            !v.rowSymbol || !v.columnSymbol || !v.productionLhs || !v.rhsStart || !v.rhsSymbols || !v.cells ||
+            !v.rowOffset || !v.combValue || !v.combOwner || !v.syncSets) {
+            return fail(filename + " has a damaged section directory");
+        }
+        return true;
+    }
+
+    const ParseTableView& view() const {
+        return tableView;
+    }
+
+    const string& error() const {
+        return errorText;
+    }
+};
@@ -0,0 +1,118 @@
+// Dense bitsets of terminals used for FIRST and FOLLOW sets
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+// Bit 0 of every set is reserved for ε (terminal index 0)
+const int EPSILON_BIT = 0;
+
+// Function to OR src into dst; returns true if dst gained at least one bit.
+// firstWordMask lets callers drop ε (bit 0) from src without copying it.
+inline bool unionBits(uint64_t* dst, const uint64_t* src, int words, uint64_t firstWordMask = ~0ULL) {
+    if (words == 0) return false;
+    uint64_t first = src[0] & firstWordMask;
+    uint64_t gained = first & ~dst[0];
+    dst[0] |= first;
+
+    int i = 1;
+#ifdef __AVX2__
+    __m256i added = _mm256_setzero_si256();
+    for (; i + 4 <= words; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        added = _mm256_or_si256(added, _mm256_andnot_si256(a, b));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(a, b));
+    }
+    if (!_mm256_testz_si256(added, added)) gained |= 1;
+#endif
+    for (; i < words; ++i) {
+        gained |= src[i] & ~dst[i];
+        dst[i] |= src[i];
+    }
+    return gained != 0;
+}
+
+// Function to get the index of the lowest set bit of a non-zero word
+inline int lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// One fixed-width bitset per row, all stored in a single contiguous buffer
+class TerminalSets {
+private:
+    int wordsPerSet = 0;
+    vector<uint64_t> bits;
+
+public:
+    // Constructor
+    TerminalSets(int sets = 0, int terminals = 0)
+        : wordsPerSet((terminals + 63) / 64), bits((size_t)sets * wordsPerSet, 0) {}
+
+    int words() const { return wordsPerSet; }
+    int size() const { return wordsPerSet ? bits.size() / wordsPerSet : 0; }
+    vector<uint64_t>& raw() { return bits; }
+    const vector<uint64_t>& raw() const { return bits; }
+    uint64_t* row(int set) { return bits.data() + (size_t)set * wordsPerSet; }
+    const uint64_t* row(int set) const { return bits.data() + (size_t)set * wordsPerSet; }
+
+    bool test(int set, int terminal) const {
+        return (row(set)[terminal >> 6] >> (terminal & 63)) & 1;
+    }
+
+    // Function to add one terminal; returns true if it was not already present
+    bool insert(int set, int terminal) {
+        uint64_t& word = row(set)[terminal >> 6];
+        uint64_t bit = 1ULL << (terminal & 63);
+        bool added = !(word & bit);
+        word |= bit;
+        return added;
+    }
+
+    // Function to add another set to this one; returns true if anything was added
+    bool unite(int set, const uint64_t* src, bool withEpsilon = true) {
+        return unionBits(row(set), src, wordsPerSet, withEpsilon ? ~0ULL : ~(1ULL << EPSILON_BIT));
+    }
+
+    // Function to change the number of sets; new sets are empty
+    void resize(int sets) {
+        bits.resize((size_t)sets * wordsPerSet, 0);
+    }
+
+    void clear(int set) {
+        uint64_t* words = row(set);
+        for (int i = 0; i < wordsPerSet; ++i) words[i] = 0;
+    }
+
+    bool empty(int set) const {
+        const uint64_t* words = row(set);
+        for (int i = 0; i < wordsPerSet; ++i) {
+            if (words[i]) return false;
+        }
+        return true;
+    }
+
+    // Function to call f(terminal) for every terminal in a set, in index order
+    template <typename F>
+    void forEach(int set, F f) const {
+        const uint64_t* words = row(set);
+        for (int i = 0; i < wordsPerSet; ++i) {
+            for (uint64_t word = words[i]; word; word &= word - 1) {
+                f(i * 64 + lowestBit(word));
+            }
+        }
+    }
+};
@@ -0,0 +1,115 @@
+// Reading a CFG file and left factoring it over token sequences
+
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <set>
+#include <cstdint>
+#include <unordered_map>
+#include "Grammar.cpp"
+#include "GrammarReader.cpp"
+
+using namespace std;
+
+// Prefix trie over the token sequences of one non-terminal's alternatives.
+// A child entry of -1 marks that an alternative ends at that node.
+struct AlternativeTrie {
+    vector<vector<int>> children;        // node -> child nodes in first-seen order
+    vector<int> edgeSymbol;              // node -> symbol on the edge from its parent
+    unordered_map<uint64_t, int> edges;  // (node, symbol) -> child node
+
+    void clear() {
+        children.assign(1, vector<int>());
+        edgeSymbol.assign(1, -1);
+        edges.clear();
+    }
+
+    void insert(SymbolSpan alternative) {
+        int node = 0;
+        for (int symbol : alternative) {
+            uint64_t key = ((uint64_t)node << 32) | (uint32_t)symbol;
+            auto found = edges.find(key);
+            if (found == edges.end()) {
+                int child = children.size();
+                children.emplace_back();
+                edgeSymbol.push_back(symbol);
+                children[node].push_back(child);
+                found = edges.emplace(key, child).first;
+            }
+            node = found->second;
+        }
+        // Duplicate alternatives end at the same node and collapse into one
+        for (int child : children[node]) {
+            if (child == -1) return;
+        }
+        children[node].push_back(-1);
+    }
+};
+
+// Helper function to turn the subtree below node into alternatives, creating one
+// new non-terminal for every branching point reached after a non-empty prefix
+void emitFactoredAlternatives(const AlternativeTrie& trie, int node, Grammar& grammar,
+                              const string& base, int& counter, AlternativeList& out) {
+    for (int child : trie.children[node]) {
+        if (child == -1) {
+            out.close();  // ε
+            continue;
+        }
+
+        // Follow the chain of single-child nodes: that is the common prefix
+        out.push(trie.edgeSymbol[child]);
+        int current = child;
+        while (trie.children[current].size() == 1 && trie.children[current][0] != -1) {
+            current = trie.children[current][0];
+            out.push(trie.edgeSymbol[current]);
+        }
+
+        if (trie.children[current].size() > 1) {
+            int fresh = grammar.freshNonTerminal(base + to_string(++counter));
+            grammar.nonTerminals.push_back(fresh);
+            AlternativeList suffixes;
+            emitFactoredAlternatives(trie, current, grammar, base, counter, suffixes);
+            grammar.setRule(fresh, suffixes);
+            out.push(fresh);
+        }
+        out.close();
+    }
+}
+
+// Left factoring function: factors every group of alternatives that share a
+// prefix in one step. Runs in time linear in the grammar size and returns the
+// number of non-terminals it introduced.
+int leftFactoring(Grammar& grammar) {
+    int created = 0;
+    AlternativeTrie trie;
+    AlternativeList factored;
+    vector<int> original = grammar.nonTerminals;
+
+    for (int nonTerminal : original) {
+        trie.clear();
+        for (SymbolSpan alternative : grammar.rule(nonTerminal)) {
+            trie.insert(alternative);
+        }
+
+        int counter = 0;
+        factored.clear();
+        emitFactoredAlternatives(trie, 0, grammar, grammar.symbols.name(nonTerminal), counter, factored);
+        grammar.setRule(nonTerminal, factored);
+        created += counter;
+    }
+    return created;
+}
+
+// Function to read CFG from file
+void readCFGFromFile(const string& filename, vector<string>& prodleft, vector<string>& prodright) {
+    GrammarSource source;
+    if (!readGrammarFile(filename, source)) return;
+    const ProductionList& productions = source.productions;
+    for (size_t p = 0; p < productions.size(); ++p) {
+        prodleft.emplace_back(productions.lhs[p]);
+        prodright.push_back(productions.rhsText(p));
+    }
+}
@@ -1,3 +1,4 @@
+#pragma once
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -6,6 +7,9 @@
 #include <set>
 #include <string>
 #include <algorithm>
+#include "Grammar.cpp"
+#include "GrammarReader.cpp"
+#include "Digraph.cpp"
 
 using namespace std;
 
@@ -19,103 +23,209 @@ struct Production {
 // Read CFG from file and preserve order
 vector<pair<string, Production>> readCFG(const string& filename) {
     vector<pair<string, Production>> cfg;
-    ifstream file(filename);
-    if (!file) {
-        cerr << "Error opening file: " << filename << endl;
-        return cfg;
+    GrammarSource source;
+    if (!readGrammarFile(filename, source)) return cfg;
+
+    // Consecutive alternatives of one non-terminal share an entry
+    const ProductionList& productions = source.productions;
+    for (size_t p = 0; p < productions.size(); ++p) {
+        string lhs(productions.lhs[p]);
+        if (cfg.empty() || cfg.back().first != lhs) cfg.emplace_back(lhs, Production{lhs, {}});
+        cfg.back().second.rhs.push_back(productions.rhsText(p));
     }
+    return cfg;
+}
 
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string lhs, arrow, rest;
-        ss >> lhs >> arrow;
-        getline(ss, rest);
-        rest = rest.substr(rest.find_first_not_of(" \t"));
-
-        Production prod;
-        prod.lhs = lhs;
-
-        stringstream rhsStream(rest);
-        string production;
-        while (getline(rhsStream, production, '|')) {
-            production = production.substr(production.find_first_not_of(" \t"));
-            prod.rhs.push_back(production);
-        }
-
-        cfg.emplace_back(lhs, prod);
+// Helper function to append one symbol to every alternative of a list
+void appendToEach(AlternativeList& list, int symbol) {
+    AlternativeList extended;
+    extended.symbols.reserve(list.symbols.size() + list.size());
+    for (size_t i = 0; i < list.size(); ++i) {
+        SymbolSpan rhs = list[i];
+        extended.symbols.insert(extended.symbols.end(), rhs.begin(), rhs.end());
+        extended.push(symbol);
+        extended.close();
     }
-    file.close();
-    return cfg;
+    list.swap(extended);
 }
 
-// Eliminate left recursion while preserving order
-void eliminateLeftRecursion(vector<pair<string, Production>>& cfg) {
-    vector<pair<string, Production>> newProds;
+// Helper function to remove immediate left recursion from one non-terminal:
+// A -> A α | β  becomes  A -> β A'  and  A' -> α A' | ε
+bool eliminateImmediateLeftRecursion(Grammar& grammar, int nonTerminal) {
+    AlternativeList alpha, beta;
+    for (SymbolSpan rhs : grammar.rule(nonTerminal)) {
+        if (!rhs.empty() && rhs[0] == nonTerminal) {
+            if (rhs.size() > 1) alpha.add(SymbolSpan(rhs.begin() + 1, rhs.end()));
+        } else {
+            beta.add(rhs);
+        }
+    }
+    if (alpha.empty()) {
+        // Only useless A -> A alternatives were recursive
+        if (beta.size() != grammar.rule(nonTerminal).size()) grammar.setRule(nonTerminal, beta);
+        return false;
+    }
+
+    int newNonTerminal = grammar.freshNonTerminal(grammar.symbols.name(nonTerminal) + "'");
+    if (beta.empty()) beta.close();
+    appendToEach(beta, newNonTerminal);
+    appendToEach(alpha, newNonTerminal);
+    alpha.close(); // ε
 
-    for (auto& [nonTerminal, prod] : cfg) {
-        vector<string> alpha, beta;
+    grammar.setRule(nonTerminal, beta);
+    grammar.setRule(newNonTerminal, alpha);
+    grammar.nonTerminals.push_back(newNonTerminal);
+    return true;
+}
 
-        for (const string& rhs : prod.rhs) {
-            if (rhs.substr(0, nonTerminal.size()) == nonTerminal &&
-                (rhs[nonTerminal.size()] == ' ' || rhs.size() == nonTerminal.size())) {
-                alpha.push_back(rhs.substr(nonTerminal.size()));
-                alpha.back() = alpha.back().substr(alpha.back().find_first_not_of(" \t"));
-            } else {
-                beta.push_back(rhs);
+// Helper function to report left recursion that hides behind a nullable prefix
+// (A -> B A x with B =>* ε), which substitution on leading symbols cannot remove
+void warnHiddenLeftRecursion(const Grammar& grammar) {
+    int symbolCount = grammar.symbols.size();
+    vector<bool> nullable(symbolCount, false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int nonTerminal : grammar.nonTerminals) {
+            if (nullable[nonTerminal]) continue;
+            for (SymbolSpan rhs : grammar.rule(nonTerminal)) {
+                bool all = true;
+                for (int symbol : rhs) all = all && nullable[symbol];
+                if (all) {
+                    nullable[nonTerminal] = changed = true;
+                    break;
+                }
             }
         }
+    }
 
-        if (!alpha.empty()) {
-            string newNonTerminal = nonTerminal + "'";
-            Production newProd;
-            newProd.lhs = newNonTerminal;
-
-            prod.rhs.clear();
-            for (string& b : beta) {
-                prod.rhs.push_back(b + " " + newNonTerminal);
+    vector<vector<int>> leftCorner(symbolCount);
+    for (int nonTerminal : grammar.nonTerminals) {
+        for (SymbolSpan rhs : grammar.rule(nonTerminal)) {
+            for (int symbol : rhs) {
+                if (grammar.isNonTerminal(symbol)) leftCorner[nonTerminal].push_back(symbol);
+                if (!nullable[symbol]) break;
             }
+        }
+    }
+    vector<int> component;
+    int componentCount = stronglyConnectedComponents(leftCorner, component);
+    vector<int> size(componentCount, 0);
+    for (int nonTerminal : grammar.nonTerminals) size[component[nonTerminal]]++;
+    for (int nonTerminal : grammar.nonTerminals) {
+        bool recursive = size[component[nonTerminal]] > 1;
+        for (int corner : leftCorner[nonTerminal]) recursive |= corner == nonTerminal;
+        if (recursive) {
+            cerr << "Warning: " << grammar.symbols.name(nonTerminal)
+                 << " is still left recursive through a nullable prefix" << endl;
+        }
+    }
+}
+
+// Eliminate direct and indirect left recursion while preserving order.
+// Only non-terminals on a cycle of the left-corner graph (A -> B ... with B as
+// the first symbol) are ordered and substituted into each other, so the rest
+// of the grammar is never expanded. Returns the number of new non-terminals.
+int eliminateLeftRecursion(Grammar& grammar) {
+    grammar.grow();
+    int symbolCount = grammar.symbols.size();
+
+    // Left-corner graph over the leading symbol of every alternative
+    vector<vector<int>> leftCorner(symbolCount);
+    for (int nonTerminal : grammar.nonTerminals) {
+        for (SymbolSpan rhs : grammar.rule(nonTerminal)) {
+            if (!rhs.empty() && grammar.isNonTerminal(rhs[0])) leftCorner[nonTerminal].push_back(rhs[0]);
+        }
+    }
+    vector<int> component;
+    int componentCount = stronglyConnectedComponents(leftCorner, component);
+
+    // Members of each component in grammar order, components ordered by their first member
+    vector<vector<int>> members(componentCount);
+    vector<int> componentOrder;
+    for (int nonTerminal : grammar.nonTerminals) {
+        if (members[component[nonTerminal]].empty()) componentOrder.push_back(component[nonTerminal]);
+        members[component[nonTerminal]].push_back(nonTerminal);
+    }
 
-            for (string& a : alpha) {
-                newProd.rhs.push_back(a + " " + newNonTerminal);
+    int created = 0;
+    AlternativeList expanded;
+    vector<int> order(symbolCount, -1);
+    for (int c : componentOrder) {
+        const vector<int>& cycle = members[c];
+        bool selfLoop = false;
+        if (cycle.size() == 1) {
+            for (int corner : leftCorner[cycle[0]]) selfLoop |= corner == cycle[0];
+            if (!selfLoop) continue;
+        }
+        for (size_t i = 0; i < cycle.size(); ++i) order[cycle[i]] = i;
+
+        // Paull's algorithm restricted to the cycle: substitute earlier members
+        // into later ones, then remove the immediate recursion that results
+        for (size_t i = 0; i < cycle.size(); ++i) {
+            int Ai = cycle[i];
+            bool substituted = true;
+            while (substituted) {
+                substituted = false;
+                expanded.clear();
+                for (SymbolSpan rhs : grammar.rule(Ai)) {
+                    int lead = rhs.empty() ? -1 : rhs[0];
+                    if (lead >= 0 && lead != Ai && order[lead] >= 0 && order[lead] < (int)i &&
+                        component[lead] == component[Ai]) {
+                        for (SymbolSpan leadRhs : grammar.rule(lead)) {
+                            expanded.symbols.insert(expanded.symbols.end(), leadRhs.begin(), leadRhs.end());
+                            expanded.symbols.insert(expanded.symbols.end(), rhs.begin() + 1, rhs.end());
+                            expanded.close();
+                        }
+                        substituted = true;
+                    } else {
+                        expanded.add(rhs);
+                    }
+                }
+                if (substituted) grammar.setRule(Ai, expanded);
             }
-            newProd.rhs.push_back(EPSILON);
 
-            newProds.emplace_back(newNonTerminal, newProd);
+            // Drop duplicates introduced by substitution
+            expanded.clear();
+            for (SymbolSpan rhs : grammar.rule(Ai)) expanded.add(rhs);
+            size_t before = expanded.size();
+            expanded.removeDuplicates();
+            if (expanded.size() != before) grammar.setRule(Ai, expanded);
+
+            if (eliminateImmediateLeftRecursion(grammar, Ai)) created++;
         }
+        for (int nonTerminal : cycle) order[nonTerminal] = -1;
     }
 
-    // Append new productions (A') at the end
-    for (const auto& p : newProds) {
-        cfg.push_back(p);
-    }
+    warnHiddenLeftRecursion(grammar);
+    return created;
 }
 
-// Print final grammar preserving order
-void printCFG(const vector<pair<string, Production>>& cfg) {
+// Print final grammar preserving order (and save it to finalGrammar.txt)
+void printCFG(const vector<pair<string, Production>>& cfg, bool toConsole = true) {
     ofstream outputFile("finalGrammar.txt");
     if (!outputFile) {
         cerr << "Error: Could not open file for writing final grammar.\n";
         return;
     }
 
-    cout << "\nFinal Grammar after removing left recursion:\n";
+    if (toConsole) cout << "\nFinal Grammar after removing left recursion:\n";
     outputFile << "Final Grammar after removing left recursion:\n";
 
     for (const auto& [nonTerminal, prod] : cfg) {
-        cout << prod.lhs << " -> ";
+        if (toConsole) cout << prod.lhs << " -> ";
         outputFile << prod.lhs << " -> ";
 
         for (size_t i = 0; i < prod.rhs.size(); ++i) {
-            cout << prod.rhs[i];
+            if (toConsole) cout << prod.rhs[i];
             outputFile << prod.rhs[i];
 
             if (i < prod.rhs.size() - 1) {
-                cout << " | ";
+                if (toConsole) cout << " | ";
                 outputFile << " | ";
             }
         }
-        cout << endl;
+        if (toConsole) cout << endl;
         outputFile << endl;
     }
 
@@ -1,437 +1,182 @@
 #include <iostream>
-#include <fstream>
-#include <vector>
 #include <string>
-#include <sstream>
-#include <unordered_set>
-#include <map>
-#include <set>
-#include <unordered_map>
-#include <iomanip>
-#include "leftRecursion.cpp"  // Assume this file contains the left recursion elimination code
-#include "FirstFollow.cpp"    // Assume this file contains the First and Follow set computation code
-
-#define EPSILON "ε"
+#include "Pipeline.cpp"       // load -> left factoring -> left recursion -> FIRST/FOLLOW -> LL(1) table
+#include "ParseEngine.cpp"    // LL(1) stack machine that parses token streams with the table
+#include "IncrementalGrammar.cpp" // recompute only what an edited production affects
+#include "TableImage.cpp"     // binary table image that parsers map and use without loading
+#include "BatchParser.cpp"    // parse many inputs on a work-stealing thread pool
+#include "StreamParser.cpp"   // parse inputs larger than memory in fixed-size chunks
+#include "PipelinedParser.cpp" // tokenize on one thread while another parses
+#include "ParserEmitter.cpp"  // write a direct-coded C++ parser for the grammar
+#include "CompiledGrammar.cpp" // expression grammar compiled into the binary at build time
 
 using namespace std;
 
-// Helper function to trim leading and trailing spaces
-string trim2(const string& str) {
-    int start = 0, end = str.length() - 1;
-    while (start <= end && (str[start] == ' ' || str[start] == '\t')) 
-        start++;
-    while (end >= start && (str[end] == ' ' || str[end] == '\t')) 
-        end--;
-    return str.substr(start, end - start + 1);
-}
-
-// Left factoring function
-void leftFactoring(vector<string>& left_production, vector<string>& right_production) {
-    int production = left_production.size();
-    int e = 1;
-    
-    for (int i = 0; i < production; ++i) {
-        for (int j = i + 1; j < production; ++j) {
-            if (left_production[j] == left_production[i]) {
-                int k = 0;
-                string common = "";
-                while (k < right_production[i].length() && k < right_production[j].length() &&
-                       right_production[i][k] == right_production[j][k]) {
-                    common += right_production[i][k];
-                    k++;
-                }
-                if (k == 0) continue;
-
-                string newNonTerminal = left_production[i] + to_string(e);
-                string suffix1 = (k < right_production[i].length()) ? trim2(right_production[i].substr(k)) : EPSILON;
-                string suffix2 = (k < right_production[j].length()) ? trim2(right_production[j].substr(k)) : EPSILON;
-
-                left_production.push_back(newNonTerminal);
-                right_production.push_back(suffix1 + " | " + suffix2);
-
-                right_production[i] = trim2(common) + " " + newNonTerminal;
-                right_production[j] = "";
-
-                production++;
-                e++;
-            }
-        }
-    }
-
-    set<string> uniqueProductions;
-    vector<string> uniqueRightProduction;
-    vector<string> uniqueLeftProduction;
-
-    for (int i = 0; i < left_production.size(); ++i) {
-        if (right_production[i].empty()) continue;
-        string productionRule = left_production[i] + " → " + right_production[i];
-        if (uniqueProductions.find(productionRule) == uniqueProductions.end()) {
-            uniqueProductions.insert(productionRule);
-            uniqueLeftProduction.push_back(left_production[i]);
-            uniqueRightProduction.push_back(right_production[i]);
-        }
-    }
-
-    left_production = uniqueLeftProduction;
-    right_production = uniqueRightProduction;
-}
-
-// Helper function to join vector elements into a string with separator
-string join(const vector<string>& vec, const string& separator) {
-    stringstream ss;
-    for (size_t i = 0; i < vec.size(); ++i) {
-        ss << vec[i];
-        if (i != vec.size() - 1) ss << separator;
-    }
-    return ss.str();
-}
-
-// Function to read FOLLOW sets from a file
-map<string, set<string>> readFollowSetsFromFile(const string& filename) {
-    map<string, set<string>> followSets;
-    ifstream inputFile(filename);
-    string line;
-
-    while (getline(inputFile, line)) {
-        // Skip empty lines
-        if (line.empty()) continue;
-
-        size_t posStart = line.find("FOLLOW(");
-        size_t posEnd = line.find(')', posStart);
-        if (posStart == string::npos || posEnd == string::npos) continue;
-
-        string nonTerminal = line.substr(posStart + 7, posEnd - posStart - 7);
-
-        size_t braceStart = line.find('{', posEnd);
-        size_t braceEnd = line.find('}', braceStart);
-        if (braceStart == string::npos || braceEnd == string::npos) continue;
-
-        string elements = line.substr(braceStart + 1, braceEnd - braceStart - 1);
-        stringstream ss(elements);
-        string token;
-        set<string> followSet;
-
-        while (ss >> token) {
-            if (token != "{" && token != "}") {
-                followSet.insert(token);
-            }
-        }
-
-        followSets[nonTerminal] = followSet;
-    }
-
-    inputFile.close();
-    return followSets;
-}
-
-// Helper function to print the LL(1) parsing table
-void printParsingTable(const unordered_map<string, unordered_map<string, string>>& parsingTable) {
-    // Print the header row
-    cout << setw(15) << "Non-Terminal";
-    unordered_set<string> terminals;
-    for (const auto& row : parsingTable) {
-        for (const auto& col : row.second) {
-            terminals.insert(col.first);
-        }
-    }
-    for (const auto& terminal : terminals) {
-        cout << setw(15) << terminal;
-    }
-    cout << endl;
-
-    // Print the table contents
-    for (const auto& row : parsingTable) {
-        cout << setw(15) << row.first;
-        for (const auto& terminal : terminals) {
-            auto terminalEntry = row.second.find(terminal);
-            if (terminalEntry != row.second.end()) {
-                cout << setw(15) << terminalEntry->second;
-            } else {
-                cout << setw(15) << "";
-            }
-        }
-        cout << endl;
-    }
-}
-
-// Function to construct the LL(1) parsing table// Adjusted part where map.at() is used
-unordered_map<string, unordered_map<string, string>> generateLL1ParsingTable(
-    const map<string, vector<vector<string>>>& formattedCFG,
-    const map<string, set<string>>& firstSets,
-    const map<string, set<string>>& followSets) {
-
-    unordered_map<string, unordered_map<string, string>> parsingTable;
-
-    for (const auto& [nonTerminal, productions] : formattedCFG) {
-        for (const auto& production : productions) {
-            set<string> firstOfProduction;
-            bool epsilonInAll = true;
-
-            for (const string& symbol : production) {
-                if (firstSets.count(symbol)) {
-                    for (const string& terminal : firstSets.at(symbol)) {
-                        if (terminal != "ε") {
-                            firstOfProduction.insert(terminal);
-                        }
-                    }
-                    if (firstSets.at(symbol).find("ε") == firstSets.at(symbol).end()) {
-                        epsilonInAll = false;
-                        break;
-                    }
-                } else {
-                    // Terminal symbol (not in FIRST sets)
-                    firstOfProduction.insert(symbol);
-                    epsilonInAll = false;
-                    break;
-                }
-            }
-
-            // Add production to parsing table for terminals in FIRST
-            for (const string& terminal : firstOfProduction) {
-                if (terminal != "ε") {
-                    parsingTable[nonTerminal][terminal] = nonTerminal + " -> " + join(production, " ");
-                }
-            }
-
-            // If production derives ε, use FOLLOW set (including $ if present)
-            if (epsilonInAll || (production.size() == 1 && production[0] == "ε")) {
-                for (const string& terminal : followSets.at(nonTerminal)) {
-                    parsingTable[nonTerminal][terminal] = nonTerminal + " -> ε";
-                }
-            }
-        }
-
-        // Ensure $ is explicitly added to the parsing table if it exists in FOLLOW
-        if (followSets.at(nonTerminal).count("$")) {
-            if (parsingTable[nonTerminal].count("$") == 0) {
-                parsingTable[nonTerminal]["$"] = ""; // Can initialize with an empty string or specific rule
-            }
-        }
-    }
-
-    return parsingTable;
-}
-
-void saveParsingTableToFile(const unordered_map<string, unordered_map<string, string>>& parsingTable, const string& filename) {
-    ofstream outFile(filename);
-    if (!outFile.is_open()) {
-        cerr << "Error: Could not open file " << filename << " for writing." << endl;
-        return;
-    }
-
-    // Collect all terminals
-    unordered_set<string> terminals;
-    for (const auto& row : parsingTable) {
-        for (const auto& col : row.second) {
-            terminals.insert(col.first);
+// Usage: temp [--grammar cfg.txt] [--compress] [--dump] [--cache | --cache-dir DIR] [--edit "A -> x | y"]...
+//             [--save-table table.ll1t] [--emit-parser GeneratedParser.cpp] [input.txt]
+//        temp --table table.ll1t input.txt     (parse with a saved table image, skipping the grammar)
+//        temp --builtin input.txt              (parse with the compiled-in expression grammar)
+//        --batch FILE|DIR [--threads N]          (validate every line of a file or directory in parallel)
+//        --threads N                             (also computes FIRST/FOLLOW on N threads; default 1)
+//        --stats FILE                            (cost of every pipeline stage as JSON; "-" for stdout)
+//        --stream FILE [--whole] [--chunk BYTES] (parse in constant memory; --whole: the file is one input)
+//        --stream FILE --pipeline | --batched    (tokenize in batches on a second thread, or on this one)
+//        --tree                                  (print the parse tree of every accepted line of input.txt)
+//        --recover                               (report every syntax error of a line, not just the first)
+//        --lex-spec FILE                         (tokenize input.txt with a lexer generated from the terminals
+//                                                 and FILE's "name = regex" lines; "-" for terminals only;
+//                                                 also used by --batch, --pipeline and --batched)
+
+int main(int argc, char* argv[]) {
+    string filename = "cfg.txt";
+    string inputFile, tableImage, saveTable, emitParser;
+    string batchPath, streamPath, statsFile;
+    StreamOptions streamOptions;
+    int threads = 0;
+    bool builtin = false, batched = false;
+    ParseInputOptions parseOptions;
+    string lexSpec;
+    vector<string> edits;
+    PipelineOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--grammar" && i + 1 < argc) filename = argv[++i];
+        else if (arg == "--compress") options.compressTable = true;
+        else if (arg == "--dump") options.dumpFiles = true;
+        else if (arg == "--cache") options.cacheDirectory = ".ll1cache";
+        else if (arg == "--cache-dir" && i + 1 < argc) options.cacheDirectory = argv[++i];
+        else if (arg == "--edit" && i + 1 < argc) edits.push_back(argv[++i]);
+        else if (arg == "--table" && i + 1 < argc) tableImage = argv[++i];
+        else if (arg == "--save-table" && i + 1 < argc) saveTable = argv[++i];
+        else if (arg == "--builtin") builtin = true;
+        else if (arg == "--emit-parser" && i + 1 < argc) emitParser = argv[++i];
+        else if (arg == "--batch" && i + 1 < argc) batchPath = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = options.threads = stoi(argv[++i]);
+        else if (arg == "--stream" && i + 1 < argc) streamPath = argv[++i];
+        else if (arg == "--stats" && i + 1 < argc) statsFile = argv[++i];
+        else if (arg == "--tree") parseOptions.printTrees = true;
+        else if (arg == "--recover") parseOptions.recover = true;
+        else if (arg == "--lex-spec" && i + 1 < argc) lexSpec = argv[++i];
+        else if (arg == "--whole") streamOptions.linePerInput = false;
+        else if (arg == "--chunk" && i + 1 < argc) streamOptions.chunkSize = stoul(argv[++i]);
+        else if (arg == "--pipeline") batched = streamOptions.pipelined = true;
+        else if (arg == "--batched") batched = true;
+        else inputFile = arg;
+    }
+
+    // Heap use is only counted when it will be reported
+    if (!statsFile.empty()) countHeapUse(true);
+
+    // Inputs are tokenized by a generated lexer when a spec is given (built once per table)
+    DfaLexer lexer;
+    auto buildLexer = [&](const ParseTableView& table) {
+        if (lexSpec.empty() || parseOptions.lexer) return true;
+        vector<LexRule> rules;
+        if (lexSpec != "-" && !loadLexerSpec(lexSpec, rules)) return false;
+        if (!lexer.build(table, rules)) {
+            cerr << "Error: " << lexer.error() << endl;
+            return false;
         }
-    }
-
-    // Write the header row
-    outFile << setw(15) << "Non-Terminal";
-    for (const auto& terminal : terminals) {
-        outFile << setw(15) << terminal;
-    }
-    outFile << endl;
-
-    // Write the table contents
-    for (const auto& row : parsingTable) {
-        outFile << setw(15) << row.first;
-        for (const auto& terminal : terminals) {
-            auto it = row.second.find(terminal);
-            if (it != row.second.end()) {
-                outFile << setw(15) << it->second;
-            } else {
-                outFile << setw(15) << "";
-            }
+        cout << "Generated lexer: " << lexer.stateCount() << " DFA states, " << lexer.byteClasses()
+             << " byte classes" << endl;
+        parseOptions.lexer = streamOptions.lexer = &lexer;
+        return true;
+    };
+    auto runInputFile = [&](const ParseTableView& table) {
+        if (!buildLexer(table)) return false;
+        printParseStats(parseInputFile(table, inputFile, parseOptions));
+        return true;
+    };
+
+    // Batch mode: every line of a file or directory is an input, parsed in parallel
+    auto runBatch = [&](const ParseTableView& table) {
+        BatchInputs inputs;
+        if (!loadBatchInputs(batchPath, inputs) || !buildLexer(table)) return false;
+        BatchParser parser(table, threads);
+        parser.setLexer(parseOptions.lexer);
+        printBatchResult(inputs, parser.parse(inputs), true);
+        return true;
+    };
+
+    // Stream mode: rejected inputs are reported by line number only, nothing is kept
+    auto runStream = [&](const ParseTableView& table) {
+        auto report = [](size_t line, bool accepted) {
+            if (!accepted) cout << "REJECT  " << (line ? "line " + to_string(line) : string("input")) << "\n";
+        };
+        if (!batched) {
+            printParseStats(streamParseFile(table, streamPath, streamOptions, report));
+            return true;
         }
-        outFile << endl;
-    }
-
-    outFile.close();
-    cout << "Parsing table saved to: " << filename << endl;
-}
-
-
-
-// Function to read CFG from file
-void readCFGFromFile(const string& filename, vector<string>& prodleft, vector<string>& prodright) {
-    ifstream file(filename);
-    if (!file) {
-        cerr << "Error: Unable to open file " << filename << endl;
-        return;
-    }
-    string line;
-    set<string> uniqueProductions;
-
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string left, arrow, right;
-        ss >> left >> arrow;
-        getline(ss, right);
-        right = trim2(right);
-
-        if (!left.empty() && !right.empty()) {
-            stringstream rhs(right);
-            string production;
-            while (getline(rhs, production, '|')) {
-                production = trim2(production);
-                if (!production.empty()) {
-                    string productionRule = left + " → " + production;
-                    if (uniqueProductions.find(productionRule) == uniqueProductions.end()) {
-                        prodleft.push_back(left);
-                        prodright.push_back(production);
-                        uniqueProductions.insert(productionRule);
-                    }
-                }
+        if (!buildLexer(table)) return false;
+        printParseStats(pipelinedParseFile(table, streamPath, streamOptions, report));
+        return true;
+    };
+
+    // A saved table image, or the compiled-in grammar, is parsed with directly
+    if (!tableImage.empty() || builtin) {
+        MappedTableImage image;
+        ParseTableView table = EXPRESSION_GRAMMAR.view();
+        if (!tableImage.empty()) {
+            auto start = chrono::steady_clock::now();
+            if (!image.open(tableImage)) {
+                cerr << "Error: " << image.error() << endl;
+                return 1;
             }
+            cout << "Mapped table image " << tableImage << " in "
+                 << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+            table = image.view();
         }
-    }
-    file.close();
-}
-
-map<string, set<string>> readFirstSetsFromFile(const string& filename) {
-    map<string, set<string>> firstSets;
-    ifstream inputFile(filename);
-    string line;
-
-    while (getline(inputFile, line)) {
-        // Skip empty lines
-        if (line.empty()) continue;
-
-        size_t posStart = line.find("FIRST(");
-        size_t posEnd = line.find(')', posStart);
-        if (posStart == string::npos || posEnd == string::npos) continue;
-
-        string nonTerminal = line.substr(posStart + 6, posEnd - posStart - 6);
-
-        size_t braceStart = line.find('{', posEnd);
-        size_t braceEnd = line.find('}', braceStart);
-        if (braceStart == string::npos || braceEnd == string::npos) continue;
-
-        string elements = line.substr(braceStart + 1, braceEnd - braceStart - 1);
-        stringstream ss(elements);
-        string token;
-        set<string> firstSet;
-
-        while (ss >> token) {
-            if (token != "{" && token != "}") {
-                firstSet.insert(token);
-            }
-        }
-        
-
-        firstSets[nonTerminal] = firstSet;
-    }
-
-    inputFile.close();
-    return firstSets;
-}
-// Function to print FOLLOW sets
-void printFollowSets(const map<string, set<string>>& followSets) {
-    cout << "\nFOLLOW sets:\n";
-    for (const auto& entry : followSets) {
-        cout << "FOLLOW(" << entry.first << ") = { ";
-        for (const auto& val : entry.second) {
-            cout << val << " ";
+        if (!inputFile.empty() && !runInputFile(table)) return 1;
+        if (!batchPath.empty() && !runBatch(table)) return 1;
+        if (!streamPath.empty() && !runStream(table)) return 1;
+        return 0;
+    }
+
+    // Run every stage in memory; --dump also writes the intermediate files
+    GrammarPipeline pipeline(options);
+    if (!pipeline.run(filename)) return 1;
+
+    if (pipeline.loadedFromCache) cout << "Loaded compiled grammar from cache" << endl;
+
+    // Apply edits incrementally and check each against a full rebuild
+    if (!edits.empty()) {
+        IncrementalGrammar incremental(pipeline);
+        for (const string& rule : edits) {
+            EditReport report;
+            if (!incremental.edit(rule, report)) return 1;
+            cout << "Edit " << rule << ": " << (report.fullRebuild ? "full rebuild, " : "")
+                 << report.firstRecomputed << " FIRST, " << report.followRecomputed << " FOLLOW, "
+                 << report.rowsRebuilt << " table rows recomputed in " << report.milliseconds << " ms ("
+                 << (incremental.matchesFullRebuild() ? "matches" : "DIFFERS FROM") << " full rebuild)" << endl;
         }
-        cout << "}\n";
+        if (options.compressTable) compressParseTable(pipeline.table);
     }
-}
 
-// Function to print FIRST sets
-void printFirstSets(const map<string, set<string>>& firstSets) {
-        cout << "\nFIRST sets:\n";
-        for (const auto& pair : firstSets) {
-            cout << "FIRST(" << pair.first << ") = { ";
-            for (const string& s : pair.second) {
-                cout << s << " ";
-            }
-            cout << "}" << endl;
-        }
+    // Report what every stage cost
+    if (statsFile == "-") {
+        writePipelineStats(pipeline, cout);
+    } else if (!statsFile.empty()) {
+        ofstream statsOut(statsFile);
+        writePipelineStats(pipeline, statsOut);
+        if (statsOut) cout << "Pipeline stats saved to: " << statsFile << endl;
+        else cerr << "Error: Unable to write " << statsFile << endl;
     }
 
-
-int main() {
-    vector<string> left_production, right_production;
-    string filename = "cfg.txt";
-
-    // Read CFG from the file
-    readCFGFromFile(filename, left_production, right_production);
-
-    // Apply left factoring
-    leftFactoring(left_production, right_production);
-
-    // Group the productions by non-terminal
-    map<string, vector<string>> groupedProductions;
-    vector<string> nonTerminalOrder;
-
-     for (int i = 0; i < left_production.size(); ++i) {
-         if (groupedProductions.find(left_production[i]) == groupedProductions.end()) {
-             nonTerminalOrder.push_back(left_production[i]);
-         }
-         groupedProductions[left_production[i]].push_back(right_production[i]);
-     }
-
-    // // Write left-factored grammar to tempLeftFactored.txt while preserving order
-     ofstream tempFile("tempLeftFactored.txt");
-     for (const string& lhs : nonTerminalOrder) {
-         const vector<string>& rhsList = groupedProductions[lhs];
-         tempFile << lhs << " -> ";
-         for (size_t i = 0; i < rhsList.size(); ++i) {
-             tempFile << rhsList[i];
-             if (i < rhsList.size() - 1)
-                 tempFile << " | ";
-         }
-         tempFile << endl;
-     }
-     tempFile.close();
-
-    // // Read the left-factored CFG and eliminate left recursion
-     vector<pair<string, Production>> cfg = readCFG("tempLeftFactored.txt");
-     eliminateLeftRecursion(cfg);
-     printCFG(cfg);
-
-    // Convert cfg to expected format
-    map<string, vector<vector<string>>> formattedCFG;
-    for (const auto& [lhs, prod] : cfg) {
-        vector<vector<string>> rules;
-        for (const string& rhs : prod.rhs) {
-            istringstream iss(rhs);
-            vector<string> tokens;
-            string token;
-            while (iss >> token) tokens.push_back(token);
-            rules.push_back(tokens);
-        }
-        formattedCFG[lhs] = rules;
+    // Print the final grammar, the FIRST and FOLLOW sets and the LL(1) parsing table
+    cout << "\nFinal Grammar after removing left recursion:\n";
+    writeGrammar(pipeline.grammar, cout);
+    pipeline.sets->printFirstSets();
+    pipeline.sets->printFollowSets();
+    cout << endl;
+    printParsingTable(pipeline.table);
+    if (!saveTable.empty() && writeTableImage(pipeline.table, saveTable)) {
+        cout << "Table image saved to: " << saveTable << endl;
     }
+    if (!emitParser.empty()) saveDirectParser(pipeline.table, emitParser);
 
-
-    // Compute First and Follow sets, then generate LL(1) table
-    FirstFollowSet ff(formattedCFG, cfg.begin()->first);
-     ff.computeAllFirst();
-     ff.computeAllFollow();
-     ff.printFirstSets();
-     ff.printFollowSets();
-     ff.saveFirstSetsToFile("FirstSets.txt");
-     ff.saveFollowSetsToFile("FollowSets.txt");
-     map<string, set<string>> followSetsFromFile = readFollowSetsFromFile("FollowSets.txt");
-
-    // Read First sets from file (create a function similar to readFollowSetsFromFile)
-    map<string, set<string>> firstSetsFromFile = readFirstSetsFromFile("FirstSets.txt");
-
-// Print FOLLOW sets
-printFollowSets(followSetsFromFile);
-    
-printFirstSets(firstSetsFromFile);
-
-    // Generate LL(1) Parsing Table
-   auto parsingTable = generateLL1ParsingTable(formattedCFG, firstSetsFromFile, followSetsFromFile);
-
-    // Print the LL(1) parsing table
-    printParsingTable(parsingTable);
-    
-// Save it to a file
-saveParsingTableToFile(parsingTable, "parsing_table.txt");
+    // Parse an input file (one whitespace separated token string per line) with the table
+    if (!inputFile.empty() && !runInputFile(pipeline.table.view())) return 1;
+    if (!batchPath.empty() && !runBatch(pipeline.table.view())) return 1;
+    if (!streamPath.empty() && !runStream(pipeline.table.view())) return 1;
     return 0;
-}
\ No newline at end of file
+}